@@ -54,8 +54,11 @@ struct Item {
 	Item*	next_link;
 	Item*	next;
 	Item*	prev;
+	uvlong	mask;
 	int	len;
 	int	width;
+	int	score;
+	int	order;
 };
 
 EXTERN struct {
@@ -76,6 +79,7 @@ EXTERN struct {
 	int		height;
 	int		rows;
 	bool		ontop;
+	bool		count;
 	Rectangle	itemr;
 	Point		arrow;
 } menu;
@@ -91,6 +95,9 @@ EXTERN struct {
 	Item*	end;
 	Item*	sel;
 	int	maxwidth;
+	int	maxlen;
+	int	count;
+	int	total;
 } match;
 
 Font*		font;
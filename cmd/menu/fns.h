@@ -6,17 +6,23 @@ void	caret_insert(char*, bool);
 void	caret_move(int, int);
 void	caret_set(int, int);
 
+/* fuzzy.c */
+bool	fuzzy_p(Item*, char*);
+void	fuzzy_prepare(char*, bool);
+int	fuzzy_score(Item*);
+
 /* history.c */
-void	history_dump(const char*, int);
+void	history_dump(const char*, int, long);
+void	history_load(Item*);
 char*	history_search(int, char*, int);
 
 /* main.c */
 void	debug(int, const char*, ...);
-Item*	filter_list(Item*, char*);
 void	update_filter(bool);
 void	update_input(void);
 
 /* menu.c */
+int	itemwidth(Item*);
 void	menu_draw(void);
 void	menu_init(void);
 void	menu_show(void);
@@ -0,0 +1,147 @@
+#include "dat.h"
+#include <string.h>
+#include "fns.h"
+
+/*
+ * Subsequence matching, for -f. Items are first checked against a
+ * bitmask of the characters they contain, which rejects most of
+ * those which can't match with a single AND, and are then scored
+ * over the shortest window which contains the query.
+ */
+
+enum {
+	ScoreMatch		= 16,
+	BonusFirst		= 8,
+	BonusBoundary		= 8,
+	BonusConsecutive	= 6,
+	PenaltyGapStart		= 3,
+	PenaltyGap		= 1,
+};
+
+static struct {
+	uchar*	string;
+	int	len;
+	uvlong	mask;
+	bool	fold;
+} query;
+
+static inline int
+fold(int c) {
+	if(query.fold && c >= 'A' && c <= 'Z')
+		return c + ('a' - 'A');
+	return c;
+}
+
+/* Letters share a bit regardless of case, so that the mask is valid either way. */
+static inline uvlong
+charbit(int c) {
+	if(c >= 'A' && c <= 'Z')
+		c += 'a' - 'A';
+	if(c >= 'a' && c <= 'z')
+		return 1ULL << (c - 'a');
+	if(c >= '0' && c <= '9')
+		return 1ULL << (26 + c - '0');
+	return 1ULL << (36 + c % 28);
+}
+
+static uvlong
+charmask(uchar *s, int len) {
+	uvlong mask;
+	int i;
+
+	mask = 0;
+	for(i=0; i < len; i++)
+		mask |= charbit(s[i]);
+	return mask;
+}
+
+static bool
+boundary(int prev, int c) {
+
+	if(prev == ' ' || prev == '\t' || prev == '/' || prev == '-'
+	|| prev == '_' || prev == '.' || prev == ':')
+		return true;
+	return prev >= 'a' && prev <= 'z' && c >= 'A' && c <= 'Z';
+}
+
+void
+fuzzy_prepare(char *filter, bool icase) {
+	int i;
+
+	free(query.string);
+	query.string = (uchar*)estrdup(filter);
+	query.len = strlen(filter);
+	query.fold = icase;
+	for(i=0; i < query.len; i++)
+		query.string[i] = fold(query.string[i]);
+	query.mask = charmask(query.string, query.len);
+}
+
+/* Whether filter is a subsequence of i's string, independent of the query. */
+bool
+fuzzy_p(Item *i, char *filter) {
+	uchar *s, *q;
+	int j;
+
+	s = (uchar*)i->string;
+	q = (uchar*)filter;
+	for(j=0; *q && j < i->len; j++)
+		if(fold(s[j]) == fold(*q))
+			q++;
+	return *q == '\0';
+}
+
+/*
+ * Returns the score of item i against the prepared query, or -1 if
+ * it doesn't match. May be called from several threads at once, for
+ * distinct items.
+ */
+int
+fuzzy_score(Item *i) {
+	uchar *s, *q;
+	int j, k, n, start, end, score, gap, prev;
+
+	if(i->mask == 0)
+		i->mask = charmask((uchar*)i->string, i->len);
+	if(query.mask & ~i->mask)
+		return -1;
+	if(query.len == 0)
+		return 0;
+
+	s = (uchar*)i->string;
+	q = query.string;
+	n = i->len;
+
+	/* Find the end of the first occurrence, */
+	for(j=0, k=0; j < n; j++)
+		if(fold(s[j]) == q[k] && ++k == query.len)
+			break;
+	if(k < query.len)
+		return -1;
+	end = j;
+
+	/* and then the shortest window which ends there. */
+	for(k=query.len-1;; j--)
+		if(fold(s[j]) == q[k] && k-- == 0)
+			break;
+	start = j;
+
+	score = 0;
+	gap = 0;
+	prev = -2;
+	for(j=start, k=0; j <= end; j++)
+		if(k < query.len && fold(s[j]) == q[k]) {
+			score += ScoreMatch;
+			if(j == 0)
+				score += BonusFirst;
+			else if(boundary(s[j-1], s[j]))
+				score += BonusBoundary;
+			if(j == prev + 1)
+				score += BonusConsecutive;
+			prev = j;
+			gap = 0;
+			k++;
+		}else
+			score -= gap++ ? PenaltyGap : PenaltyGapStart;
+	return max(score, 0);
+}
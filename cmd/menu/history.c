@@ -1,11 +1,34 @@
 #include "dat.h"
 #include <assert.h>
 #include <bio.h>
+#include <fcntl.h>
+#include <limits.h>
 #include <stdio.h>
 #include <string.h>
 #include <unistd.h>
 #include "fns.h"
 
+#define link _link
+
+/*
+ * The history is kept oldest first, with no duplicates: a repeated
+ * entry replaces its older copy. Entries are hashed, for the
+ * deduplication, and indexed in string order, so that a prefix
+ * search needs only look at the entries which share the prefix.
+ *
+ * Accepted entries are appended to the file, which is only rewritten
+ * once it holds more than twice as many lines as it ought to keep.
+ */
+
+enum {
+	HistSlack = 32,
+};
+
+static Map		entries;
+static Vector_ptr	byname;
+static int		nlines;
+static long		nbytes;
+
 static void
 splice(Item *i) {
 	if(i->next != nil)
@@ -14,44 +37,119 @@ splice(Item *i) {
 		i->prev->next = i->next;
 }
 
+static void
+link(Item *i, Item *j) {
+	i->next = j;
+	j->prev = i;
+}
+
+static int
+namecmp(const void *a, const void *b) {
+	Item *i, *j;
+
+	i = *(Item**)a;
+	j = *(Item**)b;
+	return compare(i->string, j->string, (size_t)-1);
+}
+
+/* The first entry of byname not ordered before the first n bytes of string. */
+static int
+lowerbound(char *string, int n) {
+	int lo, hi, mid;
+
+	lo = 0;
+	hi = byname.n;
+	while(lo < hi) {
+		mid = (lo + hi) / 2;
+		if(compare(((Item*)byname.ary[mid])->string, string, n) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+void
+history_load(Item *list) {
+	Item *i, **e;
+	uint n;
+
+	histsel = &hist;
+	link(&hist, &hist);
+
+	for(n=0, i=list; i; i=i->next_link)
+		n++;
+	entries.nhash = max(n, 64);
+	entries.bucket = emallocz(entries.nhash * sizeof *entries.bucket);
+
+	for(i=list; i; i=i->next_link) {
+		nlines++;
+		nbytes += strlen(i->string) + 1;
+		e = (Item**)hash_get(&entries, i->string, true);
+		if(*e)
+			splice(*e);
+		*e = i;
+		i->order = nlines;
+		link(hist.prev, i);
+		link(i, &hist);
+	}
+
+	for(i=hist.next; i != &hist; i=i->next)
+		vector_ppush(&byname, i);
+	qsort(byname.ary, byname.n, sizeof *byname.ary, namecmp);
+}
+
 char*
 history_search(int dir, char *string, int n) {
-	Item *i;
-
-	if(dir == FORWARD) {
-		if(histsel == &hist)
-			return hist.string;
-		for(i=histsel->next; i != hist.next; i=i->next)
-			if(!i->string || !compare(i->string, string, n)) {
-				histsel = i;
-				return i->string;
-			}
-		return string;
-	}
-	assert(dir == BACKWARD);
+	Item *i, *best;
+	int k, order;
 
-	if(histsel == &hist) {
+	if(dir == FORWARD && histsel == &hist)
+		return hist.string;
+	if(dir == BACKWARD && histsel == &hist) {
 		free(hist.string);
 		hist.string = estrdup(input.string);
 	}
+	assert(dir == FORWARD || dir == BACKWARD);
 
-	for(i=histsel->prev; i != &hist; i=i->prev)
-		if(!compare(i->string, string, n)) {
-			histsel = i;
-			return i->string;
+	if(n == 0)
+		best = dir == FORWARD ? histsel->next : histsel->prev;
+	else {
+		/* The nearest entry, in time, among those which share the prefix. */
+		order = histsel == &hist ? INT_MAX : histsel->order;
+		best = nil;
+		for(k=lowerbound(string, n); k < byname.n; k++) {
+			i = byname.ary[k];
+			if(compare(i->string, string, n))
+				break;
+			if(dir == FORWARD && i->order > order
+			&& (!best || i->order < best->order))
+				best = i;
+			if(dir == BACKWARD && i->order < order
+			&& (!best || i->order > best->order))
+				best = i;
 		}
+	}
+
+	if(best && best != &hist) {
+		histsel = best;
+		return best->string;
+	}
+	if(dir == FORWARD && (!hist.string || !compare(hist.string, string, n))) {
+		histsel = &hist;
+		return hist.string;
+	}
 	return string;
 }
 
-void
-history_dump(const char *path, int max) {
-	static char *items[20];
+static void
+compact(const char *path, int count, long maxbytes) {
 	static char *tmp;
 	Biobuf b;
 	Item *h, *first;
-	int i, n, fd;
+	long size;
+	int n, fd;
 
-	SET(first);
 	if(fork() != 0)
 		return;
 
@@ -62,33 +160,61 @@ history_dump(const char *path, int max) {
 		_exit(1);
 	}
 
-	hist.string = input.string;
-	n = 0;
-	hist.next->prev = nil;
-	for(h=&hist; h; h=h->prev) {
-		for(i=0; i < nelem(items); i++)
-			if(items[i] && !strcmp(h->string, items[i])) {
-				splice(h);
-				goto next;
-			}
-		items[n++ % nelem(items)] = h->string;
-		first = h;
-		if(!max || n >= max)
+	/* The newest entries, up to count of them, or maxbytes of them. */
+	first = &hist;
+	size = strlen(hist.string) + 1;
+	for(n=1, h=hist.prev; h != &hist && n < count; n++, h=h->prev) {
+		size += strlen(h->string) + 1;
+		if(maxbytes > 0 && size > maxbytes)
 			break;
-	next:
-		continue;
+		first = h;
 	}
 
 	Binit(&b, fd, OWRITE);
-	hist.next = nil;
-	for(h=first; h; h=h->next)
+	for(h=first;; h=h->next) {
 		if(Bprint(&b, "%s\n", h->string) < 0) {
 			unlink(tmp);
 			fprint(2, "%s: Can't write temporary history file %q: %r\n", argv0, path);
 			_exit(1);
 		}
+		if(h == &hist)
+			break;
+	}
 	Bterm(&b);
 	rename(tmp, path);
 	_exit(0);
 }
 
+void
+history_dump(const char *path, int count, long maxbytes) {
+	Item **e;
+	char *s;
+	int fd, n, len;
+
+	count = max(count, 1);
+
+	/* The accepted entry, in hist, is the newest. Its older copy goes. */
+	hist.string = input.string;
+	e = (Item**)hash_get(&entries, hist.string, true);
+	if(*e)
+		splice(*e);
+	n = entries.nmemb;
+
+	len = strlen(hist.string) + 1;
+	if(nlines + 1 > 2 * min(n, count) + HistSlack
+	|| maxbytes > 0 && nbytes + len > 2 * maxbytes) {
+		compact(path, count, maxbytes);
+		return;
+	}
+
+	fd = open(path, O_WRONLY|O_APPEND|O_CREAT, 0666);
+	if(fd < 0) {
+		fprint(2, "%s: Can't open history file %q: %r\n", argv0, path);
+		return;
+	}
+	s = smprint("%s\n", hist.string);
+	if(write(fd, s, len) != len)
+		fprint(2, "%s: Can't write history file %q: %r\n", argv0, path);
+	free(s);
+	close(fd);
+}
@@ -4,8 +4,14 @@
 #define EXTERN
 #include "dat.h"
 #include <X11/Xproto.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
 #include <locale.h>
+#include <pthread.h>
 #include <strings.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 #include <bio.h>
 #include <stuff/clientutil.h>
@@ -16,12 +22,129 @@ static const char version[] = "wimenu-"VERSION", "COPYRIGHT"\n";
 static Biobuf*	cmplbuf;
 static Biobuf*	inbuf;
 static bool	alwaysprint;
+static bool	fuzzy;
+static bool	icase;
+static bool	streaming;
 static char*	cmdsep;
 static int	screen_hint;
 
+enum {
+	Exact,
+	Prefix,
+	Substr,
+};
+
+/* The runs of the match list in fuzzy mode. */
+enum {
+	Top,
+	Rest,
+	FuzzyTop = 64,
+};
+
+/* The filter which is applied to items as they arrive. */
+static struct {
+	char*	filter;
+	Item*	tail[3];
+	int	ntop;
+} current;
+static Vector_ptr	scored;
+static Item	nomatch;
+
+/*
+ * The results of successive filters, each narrower than the one
+ * beneath it, in input order. When the filter is extended, only the
+ * results of the previous one need be searched, and when it's
+ * shortened, those beneath it are reused as they are.
+ */
+typedef struct Result Result;
+struct Result {
+	Result*		next;
+	char*		filter;
+	int		len;
+	Vector_ptr	items;
+};
+static Result*	results;
+static Vector_ptr	allitems;
+
+/*
+ * Items, and the strings they hold, are carved out of large blocks
+ * in input order, rather than allocated one by one. Items keep to
+ * blocks of their own, so that filtering walks memory in order, and
+ * a list is torn down by freeing its few blocks.
+ */
+typedef struct Block Block;
+struct Block {
+	Block*	next;
+	char*	pos;
+	char*	end;
+};
+
+typedef struct Arena Arena;
+struct Arena {
+	Block*	items;
+	Block*	strings;
+};
+
+enum {
+	ItemBlock	= 4096 * sizeof(Item),
+	StringBlock	= 1024 * 1024,
+};
+
+static Arena	itemarena;
+static Arena	histarena;
+
+static struct {
+	char*	base;
+	size_t	size;
+} mapped;
+
+/*
+ * Large candidate lists are classified by a pool of worker threads,
+ * a chunk at a time. Finished chunks are merged into the match list
+ * in order, so the UI need only wait for the first page of results,
+ * and the rest follow as they're ready. A newer filter cancels
+ * whatever work remains.
+ */
+enum {
+	JobChunk	= 4096,
+	JobMin		= 4 * JobChunk,
+	JobPage		= 64,
+	JobThreads	= 8,
+};
+
+static struct {
+	pthread_mutex_t	lock;
+	pthread_cond_t	work;
+	pthread_cond_t	done;
+	int		nthread;
+	int		pipe[2];
+
+	volatile ulong	gen;
+	void**		items;
+	int*		class;
+	char*		finished;
+	char*		filter;
+	Result*		result;
+	int		len;
+	int		n;
+	int		nchunk;
+	int		next;
+	int		merged;
+	int		active;
+	bool		running;
+} job;
+
+/* Input read from stdin in streaming mode, less the items split out of it. */
+static struct {
+	char*	buf;
+	int	n;
+	int	size;
+	Item**	last;
+} stream;
+
 static void
 usage(void) {
-	fprint(2, "usage: %s -i [-a <address>] [-h <history>] [-p <prompt>] [-r <rows>] [-s <screen>]\n", argv0);
+	fprint(2, "usage: %s -i [-f] [-l] [-a <address>] [-h <history>] [-p <prompt>] [-r <rows>] [-s <screen>]\n", argv0);
 	fprint(2, "       See manual page for full usage details.\n");
 	exit(1);
 }
@@ -31,95 +154,682 @@ errfmt(Fmt *f) {
 	return fmtstrcpy(f, ixp_errbuf());
 }
 
-static inline void
-splice(Item *i) {
-	i->next->prev = i->prev;
-	i->prev->next = i->next;
-}
 static inline void
 link(Item *i, Item *j) {
 	i->next = j;
 	j->prev = i;
 }
 
+static void*
+balloc(Block **bp, int size, int n) {
+	Block *b;
+
+	b = *bp;
+	if(b == nil || b->end - b->pos < n) {
+		size = max(size, n);
+		b = emalloc(sizeof *b + size);
+		b->pos = (char*)&b[1];
+		b->end = b->pos + size;
+		b->next = *bp;
+		*bp = b;
+	}
+	b->pos += n;
+	return b->pos - n;
+}
+
+static void
+arena_free(Arena *a) {
+	Block *b;
+
+	while((b = a->items)) {
+		a->items = b->next;
+		free(b);
+	}
+	while((b = a->strings)) {
+		a->strings = b->next;
+		free(b);
+	}
+}
+
+/* p is a string of length len, which the item takes as it is. */
+static Item*
+newitem(char *p, int len, bool hist) {
+	Item *i;
+
+	i = balloc(hist ? &histarena.items : &itemarena.items, ItemBlock, sizeof *i);
+	memset(i, 0, sizeof *i);
+
+	i->string = p;
+	i->retstring = p;
+	i->len = len;
+	if(cmdsep && (p = strstr(p, cmdsep))) {
+		*p = '\0';
+		i->retstring = p + strlen(cmdsep);
+		i->len = p - i->string;
+	}
+	if(!hist) {
+		/*
+		 * Items are measured only when they're laid out. The
+		 * widest item is estimated from those which are the
+		 * longest yet seen, which are few.
+		 */
+		if(i->len > match.maxlen) {
+			match.maxlen = i->len;
+			match.maxwidth = max(itemwidth(i), match.maxwidth);
+		}
+		match.total++;
+		vector_ppush(&allitems, i);
+	}
+	return i;
+}
+
+static Item*
+copyitem(char *s, int len, bool hist) {
+	char *p;
+
+	p = balloc(hist ? &histarena.strings : &itemarena.strings, StringBlock, len + 1);
+	memcpy(p, s, len);
+	p[len] = '\0';
+	return newitem(p, len, hist);
+}
+
+/*
+ * Lines are copied straight out of the Biobuf, a bufferful at a
+ * time. If the list ends at a blank line, they're taken one at a
+ * time instead, so that what follows it is left for later.
+ */
 static Item*
 populate_list(Biobuf *buf, bool hist) {
 	Item ret;
 	Item *i;
-	char *p;
+	char *p, *q, *end;
 	bool stop;
+	int n;
 
 	stop = !hist && !isatty(buf->fid);
 	ret.next_link = nil;
 	i = &ret;
-	while((p = Brdstr(buf, '\n', true))) {
-		if(stop && p[0] == '\0')
+	while((p = stop ? Brdslice(buf, '\n', &n) : Brdlines(buf, '\n', &n))) {
+		for(end=p + n; p < end; p=q+1) {
+			q = memchr(p, '\n', end - p);
+			if(q == nil)
+				q = end;
+			if(stop && q == p)
+				goto done;
+			i->next_link = copyitem(p, q - p, hist);
+			i = i->next_link;
+		}
+	}
+done:
+	return ret.next_link;
+}
+
+/*
+ * A regular file on stdin is mapped, privately, rather than read, and
+ * its lines are split in place, so that items point straight into the
+ * mapping. If stop is set, the list ends at the first blank line, and
+ * stdin is left positioned just past it. Otherwise, blank lines are
+ * skipped.
+ */
+static bool
+map_list(int fd, bool stop, Item **list) {
+	struct stat st;
+	Item ret, *i;
+	char *base, *end, *p, *q;
+	off_t off;
+
+	off = lseek(fd, 0, SEEK_CUR);
+	if(off < 0 || fstat(fd, &st) < 0 || !S_ISREG(st.st_mode) || st.st_size <= off)
+		return false;
+	base = mmap(nil, st.st_size, PROT_READ|PROT_WRITE, MAP_PRIVATE, fd, 0);
+	if(base == MAP_FAILED)
+		return false;
+	mapped.base = base;
+	mapped.size = st.st_size;
+
+	ret.next_link = nil;
+	i = &ret;
+	end = base + st.st_size;
+	for(p=base + off; p < end; p=q+1) {
+		q = memchr(p, '\n', end - p);
+		if(q == nil) {
+			/* There may be no room to terminate the last line in place. */
+			i->next_link = copyitem(p, end - p, false);
+			i = i->next_link;
+			p = end;
 			break;
-		i->next_link = emallocz(sizeof *i);
-		i = i->next_link;
-		i->string = p;
-		i->retstring = p;
-		if(cmdsep && (p = strstr(p, cmdsep))) {
-			*p = '\0';
-			i->retstring = p + strlen(cmdsep);
 		}
-		if(!hist) {
-			i->len = strlen(i->string);
-			i->width = textwidth_l(font, i->string, i->len) + itempad;
-			match.maxwidth = max(i->width, match.maxwidth);
+		if(q == p) {
+			if(stop) {
+				p = q + 1;
+				break;
+			}
+			continue;
 		}
+		*q = '\0';
+		i->next_link = newitem(p, q - p, false);
+		i = i->next_link;
 	}
 
-	return ret.next_link;
+	lseek(fd, p - base, SEEK_SET);
+	*list = ret.next_link;
+	return true;
 }
 
+static void
+result_pop(void) {
+	Result *r;
+
+	r = results;
+	results = r->next;
+	vector_pfree(&r->items);
+	free(r->filter);
+	free(r);
+}
+
+static void	job_cancel(void);
+
 static void
 check_competions(IxpConn *c) {
+	char buf[32];
 	char *s;
+	int n;
 
-	s = Brdstr(cmplbuf, '\n', true);
+	s = Brdslice(cmplbuf, '\n', &n);
 	if(!s) {
 		ixp_hangup(c);
 		return;
 	}
-	input.filter_start = strtol(s, nil, 10);
+	n = min(n, sizeof buf - 1);
+	memcpy(buf, s, n);
+	buf[n] = '\0';
+	input.filter_start = strtol(buf, nil, 10);
+	job_cancel();
+	while(results)
+		result_pop();
+	vector_pfree(&allitems);
+	arena_free(&itemarena);
+	if(mapped.base) {
+		munmap(mapped.base, mapped.size);
+		mapped.base = nil;
+	}
+	match.total = 0;
 	match.all = populate_list(cmplbuf, false);
 	update_filter(false);
 	menu_draw();
 }
 
-Item*
-filter_list(Item *i, char *filter) {
-	static Item exact;
-	Item start, substr;
-	Item *exactp, *startp, *substrp;
-	Item **ip;
+static int
+classify(Item *i, char *filter, int len) {
 	char *p;
-	int len;
+
+	if(fuzzy)
+		return fuzzy_score(i);
+	if(!(p = find(i->string, filter)))
+		return -1;
+	if(p != i->string)
+		return Substr;
+	if(strlen(p) == len)
+		return Exact;
+	return Prefix;
+}
+
+/*
+ * Inserts i into the circular match list beginning at first, at the
+ * end of the run of exact, prefix, or substring matches to which it
+ * belongs, as recorded in tail. An empty list is represented by a
+ * lone item with a nil string.
+ */
+static Item*
+insert(Item *first, Item **tail, Item *i, int k) {
+	Item *prev;
+	int j;
+
+	for(prev=nil, j=k; prev == nil && j >= 0; j--)
+		prev = tail[j];
+	if(prev) {
+		link(i, prev->next);
+		link(prev, i);
+	}else {
+		if(first->string == nil)
+			link(i, i);
+		else {
+			link(first->prev, i);
+			link(i, first);
+		}
+		first = i;
+	}
+	tail[k] = i;
+	return first;
+}
+
+static void
+addmatch(Item *i, int k) {
+
+	match.count++;
+	if(fuzzy) {
+		i->score = k;
+		vector_ppush(&scored, i);
+	}else
+		match.first = insert(match.first, current.tail, i, k);
+}
+
+static bool
+matches(Item *i, char *filter) {
+
+	if(fuzzy)
+		return fuzzy_p(i, filter);
+	return find(i->string, filter) != nil;
+}
+
+/*
+ * Fuzzy matches are listed by score, but only the best FuzzyTop, a
+ * page or so, are ever sorted, by way of a bounded heap. The rest
+ * follow in input order. Ties go to the earlier item.
+ */
+static bool
+better(int a, int b) {
+	Item *i, *j;
+
+	i = scored.ary[a];
+	j = scored.ary[b];
+	return i->score > j->score || i->score == j->score && a < b;
+}
+
+/* The root of the heap is its worst member. */
+static void
+siftdown(int *heap, int n, int i) {
+	int c, t;
+
+	for(; (c = 2*i + 1) < n; i = c) {
+		if(c + 1 < n && better(heap[c], heap[c + 1]))
+			c++;
+		if(!better(heap[i], heap[c]))
+			break;
+		t = heap[i];
+		heap[i] = heap[c];
+		heap[c] = t;
+	}
+}
+
+static void
+fuzzy_flush(void) {
+	int *heap;
+	char *top;
+	int i, k, n, t;
+
+	n = scored.n;
+	k = min(n, FuzzyTop);
+	heap = emalloc(max(k, 1) * sizeof *heap);
+	top = emallocz(max(n, 1));
+
+	for(i=0; i < k; i++)
+		heap[i] = i;
+	for(i=k/2 - 1; i >= 0; i--)
+		siftdown(heap, k, i);
+	for(i=k; i < n; i++)
+		if(better(i, heap[0])) {
+			heap[0] = i;
+			siftdown(heap, k, 0);
+		}
+
+	/* Pop the worst first, leaving the heap sorted best first. */
+	for(i=k; i > 1; i--) {
+		t = heap[0];
+		heap[0] = heap[i - 1];
+		heap[i - 1] = t;
+		siftdown(heap, i - 1, 0);
+	}
+
+	for(i=0; i < k; i++) {
+		top[heap[i]] = 1;
+		match.first = insert(match.first, current.tail, scored.ary[heap[i]], Top);
+	}
+	for(i=0; i < n; i++)
+		if(!top[i])
+			match.first = insert(match.first, current.tail, scored.ary[i], Rest);
+	current.ntop = k;
+	scored.n = 0;
+	free(heap);
+	free(top);
+}
+
+/*
+ * Streamed items which beat the sorted run take their place in it,
+ * and push its last item out, to the head of the rest, once it
+ * holds FuzzyTop. The rest are appended in input order.
+ */
+static void
+fuzzy_insert(Item *i) {
+	Item *j;
+	int n;
+
+	if(current.ntop >= FuzzyTop && i->score <= current.tail[Top]->score) {
+		match.first = insert(match.first, current.tail, i, Rest);
+		return;
+	}
+	for(j=match.first, n=0; n < current.ntop && j->score >= i->score; j=j->next)
+		n++;
+	if(n == current.ntop)
+		match.first = insert(match.first, current.tail, i, Top);
+	else {
+		link(j->prev, i);
+		link(i, j);
+		if(j == match.first)
+			match.first = i;
+	}
+	if(++current.ntop > FuzzyTop) {
+		j = current.tail[Top];
+		current.tail[Top] = j->prev;
+		if(current.tail[Rest] == nil)
+			current.tail[Rest] = j;
+		current.ntop--;
+	}
+}
+
+static void
+narrow_item(Result *r, Item *i, char *filter, int len) {
+	int k;
+
+	if((k = classify(i, filter, len)) >= 0) {
+		if(r)
+			vector_ppush(&r->items, i);
+		addmatch(i, k);
+	}
+}
+
+static void*
+job_worker(void *aux) {
+	int *class;
+	void **items;
+	char *filter;
+	ulong gen;
+	int c, e, i, len;
+	bool wake;
+
+	USED(aux);
+	for(;;) {
+		pthread_mutex_lock(&job.lock);
+		while(job.next >= job.nchunk)
+			pthread_cond_wait(&job.work, &job.lock);
+		c = job.next++;
+		gen = job.gen;
+		items = job.items;
+		class = job.class;
+		filter = job.filter;
+		len = job.len;
+		i = c * JobChunk;
+		e = min(i + JobChunk, job.n);
+		job.active++;
+		pthread_mutex_unlock(&job.lock);
+
+		for(; i < e && job.gen == gen; i++)
+			class[i] = classify(items[i], filter, len);
+
+		pthread_mutex_lock(&job.lock);
+		job.active--;
+		wake = job.gen == gen;
+		if(wake)
+			job.finished[c] = 1;
+		pthread_cond_broadcast(&job.done);
+		pthread_mutex_unlock(&job.lock);
+
+		/*
+		 * Poke the main loop without holding the lock. The pipe
+		 * doesn't block: when it's full, the main loop has a
+		 * wakeup pending already.
+		 */
+		if(wake)
+			while(write(job.pipe[1], "", 1) < 0 && errno == EINTR)
+				;
+	}
+	return nil;
+}
+
+static void job_ready(IxpConn*);
+
+static bool
+job_init(void) {
+	pthread_t t;
+	long i, n;
+
+	if(job.nthread)
+		return job.nthread > 0;
+
+	job.nthread = -1;
+	n = min(sysconf(_SC_NPROCESSORS_ONLN), JobThreads);
+	if(n < 2 || pipe(job.pipe) < 0)
+		return false;
+	fcntl(job.pipe[0], F_SETFL, O_NONBLOCK);
+	fcntl(job.pipe[1], F_SETFL, O_NONBLOCK);
+
+	pthread_mutex_init(&job.lock, nil);
+	pthread_cond_init(&job.work, nil);
+	pthread_cond_init(&job.done, nil);
+	for(i=0; i < n; i++)
+		if(pthread_create(&t, nil, job_worker, nil) == 0) {
+			pthread_detach(t);
+			job.nthread = max(job.nthread, 0) + 1;
+		}
+	if(job.nthread > 0)
+		ixp_listen(&srv, job.pipe[0], nil, job_ready, nil);
+	return job.nthread > 0;
+}
+
+static void
+job_start(Result *r, void **items, int n, char *filter, int len) {
+
+	pthread_mutex_lock(&job.lock);
+	job.items = items;
+	job.n = n;
+	job.nchunk = (n + JobChunk - 1) / JobChunk;
+	job.class = emalloc(n * sizeof *job.class);
+	job.finished = emallocz(job.nchunk);
+	job.filter = estrdup(filter);
+	job.len = len;
+	job.result = r;
+	job.next = 0;
+	job.merged = 0;
+	job.running = true;
+	pthread_cond_broadcast(&job.work);
+	pthread_mutex_unlock(&job.lock);
+}
+
+static void
+job_free(void) {
+
+	free(job.class);
+	free(job.finished);
+	free(job.filter);
+	job.class = nil;
+	job.finished = nil;
+	job.filter = nil;
+	job.running = false;
+}
+
+/*
+ * Merges finished chunks, in order, waiting for more until at least
+ * want items match. Returns true once the whole job is merged.
+ */
+static bool
+job_merge(int want) {
+	int e, i;
+	bool ready;
+
+	while(job.merged < job.nchunk) {
+		pthread_mutex_lock(&job.lock);
+		while(!job.finished[job.merged] && match.count < want)
+			pthread_cond_wait(&job.done, &job.lock);
+		ready = job.finished[job.merged];
+		pthread_mutex_unlock(&job.lock);
+		if(!ready)
+			return false;
+
+		i = job.merged++ * JobChunk;
+		e = min(i + JobChunk, job.n);
+		for(; i < e; i++)
+			if(job.class[i] >= 0) {
+				if(job.result)
+					vector_ppush(&job.result->items, job.items[i]);
+				addmatch(job.items[i], job.class[i]);
+			}
+	}
+	job_free();
+	return true;
+}
+
+static void
+job_cancel(void) {
+
+	if(!job.running)
+		return;
+
+	pthread_mutex_lock(&job.lock);
+	job.gen++;
+	job.next = job.nchunk = 0;
+	while(job.active)
+		pthread_cond_wait(&job.done, &job.lock);
+	pthread_mutex_unlock(&job.lock);
+
+	/* The results of an unfinished job are incomplete. */
+	if(job.result && job.result == results)
+		result_pop();
+	job_free();
+}
+
+static void
+job_ready(IxpConn *c) {
+	char buf[512];
+	Item *first;
+
+	while(read(c->fd, buf, sizeof buf) > 0)
+		;
+	if(!job.running)
+		return;
+
+	first = match.first;
+	job_merge(0);
+	if(match.start == first)
+		match.start = match.first;
+	menu_draw();
+}
+
+static void
+narrow(char *filter) {
+	Result *r, *prev;
+	void **items;
+	int len, n, i;
 
 	len = strlen(filter);
-	exactp = &exact;
-	startp = &start;
-	substrp = &substr;
-	for(; i; i=i->next_link)
-		if((p = find(i->string, filter))) {
-			ip = &substrp;
-			if(p == i->string)
-				if(strlen(p) == len)
-					ip = &exactp;
-				else
-					ip = &startp;
-			link(*ip, i);
-			*ip = i;
+	while(results && (results->len > len || strncmp(results->filter, filter, results->len)))
+		result_pop();
+
+	r = nil;
+	prev = results;
+	if(len > 0 && !(prev && prev->len == len)) {
+		r = emallocz(sizeof *r);
+		r->filter = estrdup(filter);
+		r->len = len;
+		r->next = results;
+		results = r;
+	}
+
+	if(prev) {
+		items = prev->items.ary;
+		n = prev->items.n;
+	}else {
+		items = allitems.ary;
+		n = allitems.n;
+	}
+
+	if(n >= JobMin && job_init()) {
+		job_start(r, items, n, filter, len);
+		/* Fuzzy matches can't be ordered until all are scored. */
+		job_merge(fuzzy ? INT_MAX : JobPage);
+	}else
+		for(i=0; i < n; i++)
+			narrow_item(r, items[i], filter, len);
+	if(fuzzy)
+		fuzzy_flush();
+}
+
+/*
+ * Streaming mode: items are split out of stdin as it becomes
+ * readable, one chunk at a time, so that X events are serviced
+ * between chunks. New items are filtered against the current
+ * filter as they arrive.
+ */
+static void
+stream_items(Item *i) {
+	Result *r;
+	Item *first;
+	int len, k;
+
+	first = match.first;
+	len = strlen(current.filter);
+	for(; i; i=i->next_link) {
+		for(r=results; r; r=r->next)
+			if(matches(i, r->filter))
+				vector_ppush(&r->items, i);
+		if((k = classify(i, current.filter, len)) >= 0)
+			addmatch(i, k);
+	}
+	for(k=0; k < scored.n; k++)
+		fuzzy_insert(scored.ary[k]);
+	scored.n = 0;
+	if(match.start == first)
+		match.start = match.first;
+	menu_draw();
+}
+
+static void
+stream_input(IxpConn *c) {
+	enum { Chunk = 64 * 1024 };
+	Item ret, *i;
+	char *p, *q, *end;
+	int n;
+
+	/*
+	 * A running job scans allitems, or a result's items, in place,
+	 * and new items may move either array. They must also be added
+	 * to the results in input order. So the job is finished first.
+	 */
+	if(job.running)
+		job_merge(INT_MAX);
+
+	if(stream.size - stream.n <= Chunk) {
+		stream.size = max(stream.size * 2, 2 * Chunk);
+		stream.buf = erealloc(stream.buf, stream.size);
+	}
+
+	ret.next_link = nil;
+	i = &ret;
+	n = read(c->fd, stream.buf + stream.n, Chunk);
+	if(n <= 0) {
+		if(stream.n) {
+			i->next_link = copyitem(stream.buf, stream.n, false);
+			i = i->next_link;
+			stream.n = 0;
 		}
+	}else {
+		stream.n += n;
+		end = stream.buf + stream.n;
+		for(p=stream.buf; (q = memchr(p, '\n', end - p)); p=q+1)
+			if(q > p) {
+				i->next_link = copyitem(p, q - p, false);
+				i = i->next_link;
+			}
+		stream.n = end - p;
+		memmove(stream.buf, p, stream.n);
+	}
 
-	link(substrp, &exact);
-	link(startp,  &substr);
-	link(exactp,  &start);
-	splice(&substr);
-	splice(&start);
-	splice(&exact);
-	return exact.next;
+	if(ret.next_link) {
+		*stream.last = ret.next_link;
+		stream.last = &i->next_link;
+		stream_items(ret.next_link);
+	}
+	if(n <= 0)
+		ixp_hangup(c);
 }
 
 void
@@ -140,8 +850,20 @@ update_filter(bool print) {
 	if(input.pos < input.end)
 		filter = freelater(estrndup(filter, input.pos - filter));
 
+	job_cancel();
+	free(current.filter);
+	current.filter = estrdup(filter);
+	memset(current.tail, 0, sizeof current.tail);
+	current.ntop = 0;
+	if(fuzzy)
+		fuzzy_prepare(filter, icase);
+
 	match.sel = nil;
-	match.first = match.start = filter_list(match.all, filter);
+	match.count = 0;
+	link(&nomatch, &nomatch);
+	match.first = &nomatch;
+	narrow(filter);
+	match.start = match.first;
 	if(print)
 		update_input();
 }
@@ -186,6 +908,7 @@ main(int argc, char *argv[]) {
 	Item *item;
 	int i;
 	long ndump;
+	long nbytes;
 
 	setlocale(LC_ALL, "");
 	fmtinstall('r', errfmt);
@@ -197,6 +920,7 @@ main(int argc, char *argv[]) {
 	compare = strncmp;
 
 	ndump = -1;
+	nbytes = 0;
 
 	ARGBEGIN{
 	case 'a':
@@ -208,7 +932,11 @@ main(int argc, char *argv[]) {
 	case 'h':
 		histfile = EARGF(usage());
 		break;
+	case 'f':
+		fuzzy = true;
+		break;
 	case 'i':
+		icase = true;
 		find = strcasestr;
 		compare = strncasecmp;
 		break;
@@ -217,9 +945,15 @@ main(int argc, char *argv[]) {
 	case 'k':
 		keyfile = EARGF(usage());
 		break;
+	case 'l':
+		streaming = true;
+		break;
 	case 'n':
 		ndump = strtol(EARGF(usage()), nil, 10);
 		break;
+	case 'N':
+		nbytes = strtol(EARGF(usage()), nil, 10);
+		break;
 	case 'p':
 		menu.prompt = EARGF(usage());
 		break;
@@ -258,10 +992,22 @@ main(int argc, char *argv[]) {
 
 	itempad = (font->height & ~1) + font->pad.min.x + font->pad.max.x;
 
-	cmplbuf = Bfdopen(0, OREAD);
-	match.all = populate_list(cmplbuf, false);
-	if(!isatty(cmplbuf->fid))
-		ixp_listen(&srv, cmplbuf->fid, inbuf, check_competions, nil);
+	streaming = streaming && !isatty(0);
+	menu.count = streaming;
+	if(map_list(0, !streaming, &match.all)) {
+		if(!streaming) {
+			cmplbuf = Bfdopen(0, OREAD);
+			ixp_listen(&srv, cmplbuf->fid, inbuf, check_competions, nil);
+		}
+	}else if(streaming) {
+		stream.last = &match.all;
+		ixp_listen(&srv, 0, nil, stream_input, nil);
+	}else {
+		cmplbuf = Bfdopen(0, OREAD);
+		match.all = populate_list(cmplbuf, false);
+		if(!isatty(cmplbuf->fid))
+			ixp_listen(&srv, cmplbuf->fid, inbuf, check_competions, nil);
+	}
 
 	caret_insert("", true);
 	update_filter(false);
@@ -274,16 +1020,12 @@ main(int argc, char *argv[]) {
 			parse_keys(buffer);
 	}
 
-	histsel = &hist;
-	link(&hist, &hist);
+	item = nil;
 	if(histfile && (inbuf = Bopen(histfile, OREAD))) {
-		item = filter_list(populate_list(inbuf, true), "");
-		if(item->string) {
-			link(item->prev, &hist);
-			link(&hist, item);
-		}
+		item = populate_list(inbuf, true);
 		Bterm(inbuf);
 	}
+	history_load(item);
 
 	if(menu.win == nil)
 		menu_init();
@@ -296,7 +1038,7 @@ main(int argc, char *argv[]) {
 	XCloseDisplay(display);
 
 	if(ndump >= 0 && histfile && result == 0)
-		history_dump(histfile, ndump);
+		history_dump(histfile, ndump, nbytes);
 
 	return result;
 }
@@ -81,6 +81,14 @@ slice(Rectangle *rp, int x, int y) {
 	return r;
 }
 
+int
+itemwidth(Item *i) {
+
+	if(i->width == 0 && i->string)
+		i->width = textwidth_l(font, i->string, i->len) + itempad;
+	return i->width;
+}
+
 static bool
 nextrect(Item *i, Rectangle *rp, Rectangle *src) {
 	Rectangle r;
@@ -88,7 +96,7 @@ nextrect(Item *i, Rectangle *rp, Rectangle *src) {
 	if(menu.rows)
 		r = slice(src, 0, menu.height);
 	else
-		r = slice(src, i->width, 0);
+		r = slice(src, itemwidth(i), 0);
 	return (Dx(*src) >= 0 && Dy(*src) >= 0) && (*rp = r, 1);
 }
 
@@ -96,13 +104,22 @@ void
 menu_draw(void) {
 	Rectangle barr, extent, itemr, inputr, r, r2;
 	Item *item;
-	int inputw, offset;
+	char *count;
+	int countw, inputw, offset;
 
 	barr = r2 = Rect(0, 0, Dx(menu.win->r), menu.height);
 
+	SET(count);
+	countw = 0;
+	if(menu.count) {
+		count = sxprint("%d/%d", match.count, match.total);
+		countw = textwidth(font, count) + itempad;
+	}
+
 	inputw = max(match.maxwidth + textwidth_l(font, input.string, min(input.filter_start, strlen(input.string))),
 		     max(itempad    + textwidth(font, input.string),
 			 Dx(barr) / 3));
+	inputw += countw;
 
 	/* Calculate items box, w/ and w/o arrows */
 	if(menu.rows) {
@@ -165,6 +182,8 @@ menu_draw(void) {
 	/* Draw input */
 	inputr = slice(&r2, inputw, 0);
 	drawstring(menu.buf, font, inputr, West, input.string, &cnorm.fg);
+	if(menu.count)
+		drawstring(menu.buf, font, inputr, East, count, &cnorm.fg);
 
 	/* Draw cursor */
 	extent = textextents_l(font, input.string, input.pos - input.string, &offset);
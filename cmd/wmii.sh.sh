@@ -136,7 +136,7 @@ wi_fnmenu() {
 }
 
 wi_proglist() {
-        wmiir proglist -- $(echo $* | sed 'y/:/ /') | sort | uniq
+        wmiir proglist -c -- $(echo $* | sed 'y/:/ /') | sort | uniq
 }
 
 wi_actions() {
@@ -198,15 +198,13 @@ wi_nexttag() {
 wi_eventloop() {
 	echo "$Keys" | wmiir write /keys
 
-	if [ "$1" = -i ]
-	then cat
-	else wmiir read /event
-	fi |
-	while read wi_event; do
-		IFS="$wi_newline"
-		wi_arg=$(echo "$wi_event" | sed 's/^[^ ]* //')
-		unset IFS
-		set -- $wi_event
+	# wmiir passes only the events we handle, already split into
+	# words, as shell to be evaluated.
+	{	set -f
+		wmiir events $([ "$1" = -i ] && echo -i) -- $Events
+	} |
+	while read -r wi_event; do
+		eval "$wi_event"
 		event=$1; shift
 		[ "$event" = Start -a "$1" = "$wmiiscript" ] &&
 			exit
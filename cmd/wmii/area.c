@@ -232,6 +232,7 @@ area_setsel(Area *a, Frame *f) {
 	View *v;
 
 	v = a->view;
+	v->gen++;
 	/* XXX: Stack. */
 	for(; f && f->collapsed && f->anext; f=f->anext)
 		;
@@ -295,6 +296,7 @@ area_focus(Area *a) {
 		return;
 
 	v->sel = a;
+	v->gen++;
 	if(!a->floating) {
 		v->selcol = area_idx(a);
 		v->selscreen = a->screen;
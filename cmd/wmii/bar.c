@@ -125,6 +125,7 @@ bar_destroy(Bar **bp, Bar *b) {
 	for(p = bp; *p; p = &p[0]->next)
 		if(*p == b) break;
 	*p = b->next;
+	fs_forget(&b->file);
 	free(b);
 }
 
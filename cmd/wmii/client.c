@@ -24,6 +24,19 @@ enum {
 
 static Group*	group;
 
+/*
+ * Class strings are interned: clients of the same class share one
+ * copy, which goes when the last of them does.
+ */
+typedef struct Classname Classname;
+struct Classname {
+	int	ref;
+	char	string[];
+};
+
+static MapEnt*	cbucket[107];
+static Map	classmap = { cbucket, nelem(cbucket) };
+
 void
 group_init(Client *c) {
 	Group *g;
@@ -51,6 +64,7 @@ group_init(Client *c) {
 		group = g;
 	}
 	c->group = g;
+	c->gen++;
 	g->ref++;
 }
 
@@ -61,6 +75,7 @@ group_remove(Client *c) {
 
 	g = c->group;
 	c->group = nil;
+	c->gen++;
 	if(g == nil)
 		return;
 	if(g->client == c)
@@ -75,6 +90,45 @@ group_remove(Client *c) {
 	}
 }
 
+static char*
+class_intern(const char *s) {
+	Classname **cp, *cn;
+
+	cp = (Classname**)hash_get(&classmap, s, true);
+	if(*cp == nil) {
+		cn = emalloc(sizeof *cn + strlen(s) + 1);
+		cn->ref = 0;
+		strcpy(cn->string, s);
+		*cp = cn;
+	}
+	cp[0]->ref++;
+	return cp[0]->string;
+}
+
+static void
+class_release(char *s) {
+	Classname *cn;
+
+	if(s == nil)
+		return;
+	cn = (Classname*)(s - offsetof(Classname, string));
+	if(--cn->ref == 0) {
+		hash_rm(&classmap, s);
+		free(cn);
+	}
+}
+
+/* Replaces the string at *sp, of length *lp, with a copy of s. */
+static void
+client_setstring(char **sp, uint *lp, const char *s, uint n) {
+
+	free(*sp);
+	*sp = emalloc(n + 1);
+	memcpy(*sp, s, n);
+	sp[0][n] = '\0';
+	*lp = n;
+}
+
 Client*
 group_leader(Group *g) {
 	Client *c;
@@ -100,6 +154,10 @@ client_create(XWindow w, XWindowAttributes *wa) {
 	c = emallocz(sizeof *c);
 	c->fullscreen = -1;
 	c->border = wa->border_width;
+	c->class = class_intern("");
+	client_setstring(&c->name, &c->namelen, "", 0);
+	client_setstring(&c->props, &c->propslen, "", 0);
+	client_setstring(&c->tags, &c->tagslen, "", 0);
 
 	c->r = rectsetorigin(Rect(0, 0, wa->width, wa->height),
 			     Pt(wa->x, wa->y));
@@ -226,9 +284,9 @@ apply_rules(Client *c) {
 				if(!strcmp(rv->key, "continue"))
 					more = true;
 				else if(!strcmp(rv->key, "tags"))
-					utflcpy(c->tags, rv->value, sizeof c->tags);
+					client_setstring(&c->tags, &c->tagslen, rv->value, strlen(rv->value));
 				else if(!strcmp(rv->key, "force-tags")) {
-					utflcpy(c->tags, rv->value, sizeof c->tags);
+					client_setstring(&c->tags, &c->tagslen, rv->value, strlen(rv->value));
 					ret = false;
 				}else {
 					bufclear();
@@ -266,9 +324,9 @@ client_manage(Client *c) {
 
 		tags = getprop_string(&c->w, "_WMII_TAGS");
 		if(tags)
-			utflcpy(c->tags, tags, sizeof c->tags);
+			client_setstring(&c->tags, &c->tagslen, tags, strlen(tags));
 		else if(leader)
-			utflcpy(c->tags, leader->tags, sizeof c->tags);
+			client_setstring(&c->tags, &c->tagslen, leader->tags, leader->tagslen);
 		free(tags);
 	}
 
@@ -353,6 +411,11 @@ client_destroy(Client *c) {
 
 	event_flush(FocusChangeMask, true);
 	cleanupwindow(&c->w);
+	fs_forget(&c->file);
+	class_release(c->class);
+	free(c->name);
+	free(c->props);
+	free(c->tags);
 	free(c);
 }
 
@@ -659,6 +722,7 @@ fullscreen(Client *c, int fullscreen, long screen) {
 
 	event("Fullscreen %#C %s\n", c, (fullscreen ? "on" : "off"));
 
+	c->gen++;
 	c->fullscreen = -1;
 	if(!fullscreen)
 		for(f=c->frame; f; f=f->cnext) {
@@ -710,6 +774,7 @@ client_seturgent(Client *c, int urgent, int from) {
 	if(urgent != c->urgent) {
 		event("%sUrgent %#C %s\n", cnot, c, cfrom);
 		c->urgent = urgent;
+		c->gen++;
 		ewmh_updatestate(c);
 		if(c->sel)
 			frame_draw(c->sel);
@@ -734,19 +799,35 @@ client_seturgent(Client *c, int urgent, int from) {
 /* X11 stuff */
 void
 update_class(Client *c) {
-
-	snprint(c->props, sizeof c->props, "%s:%s", c->class, c->name);
+	Frame *f;
+	char *p;
+
+	free(c->props);
+	c->propslen = c->classlen + 1 + c->namelen;
+	c->props = p = emalloc(c->propslen + 1);
+	memcpy(p, c->class, c->classlen);
+	p += c->classlen;
+	*p++ = ':';
+	memcpy(p, c->name, c->namelen);
+	p[c->namelen] = '\0';
+	for(f=c->frame; f; f=f->cnext)
+		f->view->gen++;
 }
 
 static void
 client_updatename(Client *c) {
 	char *str;
 
-	c->name[0] = '\0';
-	if((str = windowname(&c->w))) {
-		utflcpy(c->name, str, sizeof c->name);
+	str = windowname(&c->w);
+	if(str == nil)
+		str = estrdup("");
+	if(!strcmp(str, c->name)) {
 		free(str);
+		return;
 	}
+	free(c->name);
+	c->name = str;
+	c->namelen = strlen(str);
 
 	update_class(c);
 	if(c->sel)
@@ -808,6 +889,7 @@ client_prop(Client *c, Atom a) {
 	WinHints h;
 	XWMHints *wmh;
 	char **class;
+	char *str;
 	int n;
 
 	if(a == xatom("WM_PROTOCOLS"))
@@ -846,11 +928,17 @@ client_prop(Client *c, Atom a) {
 		break;
 	case XA_WM_CLASS:
 		n = getprop_textlist(&c->w, "WM_CLASS", &class);
-		snprint(c->class, sizeof c->class, "%s:%s",
+		str = smprint("%s:%s",
 			(n > 0 ? class[0] : "<nil>"),
 			(n > 1 ? class[1] : "<nil>"));
 		freestringlist(class);
-		update_class(c);
+		if(str && strcmp(str, c->class)) {
+			class_release(c->class);
+			c->class = class_intern(str);
+			c->classlen = strlen(str);
+			update_class(c);
+		}
+		free(str);
 		break;
 	case XA_WM_NAME:
 	wmname:
@@ -1101,24 +1189,29 @@ client_extratags(Client *c) {
 
 bool
 client_applytags(Client *c, const char *tags) {
+	static char *orphans[] = { "orphans", nil };
 	Fmt fmt;
-	uint i, j, k;
-	char buf[512];
-	char *toks[32];
-	char **p;
-	char *cur, *s;
+	Vector_ptr tokv;
+	uint i, k, n;
+	char tagbuf[256];
+	char **toks, **p;
+	char *buf, *cur, *s;
 	int add, old;
 
-	buf[0] = 0;
-	if(memchr("+-^", tags[0], 4))
-		utflcpy(buf, c->tags, sizeof c->tags);
-	else {
+	/* The tag set is unbounded, so size the buffer to fit it. */
+	n = strlen(tags) + 1;
+	if(memchr("+-^", tags[0], 4)) {
+		buf = emalloc(c->tagslen + n);
+		memcpy(buf, c->tags, c->tagslen);
+		memcpy(buf + c->tagslen, tags, n);
+	}else {
+		buf = emalloc(n);
+		memcpy(buf, tags, n);
 		refree(&c->tagre);
 		refree(&c->tagvre);
 	}
-	strlcat(buf, tags, sizeof buf);
 
-	j = 0;
+	vector_pinit(&tokv);
 	s = buf;
 	old = '+';
 	while((cur = mask(&s, &add, &old))) {
@@ -1140,26 +1233,27 @@ client_applytags(Client *c, const char *tags) {
 			else if(Mbsearch(cur, badtags, bsstrcmp))
 				continue;
 
-			if(j < nelem(toks)-1) {
-				if(add == '^')
-					add = bsearch(cur, toks, j, sizeof *toks, bsstrcmp) ? '-' : '+';
-				if(add == '+')
-					toks[j++] = cur;
-				else {
-					for(i = 0, k = 0; i < j; i++)
-						if(strcmp(toks[i], cur))
-							toks[k++] = toks[i];
-					j = k;
-				}
+			toks = (char**)tokv.ary;
+			if(add == '^')
+				add = bsearch(cur, toks, tokv.n, sizeof *toks, bsstrcmp) ? '-' : '+';
+			if(add == '+')
+				vector_ppush(&tokv, cur);
+			else {
+				for(i = 0, k = 0; i < tokv.n; i++)
+					if(strcmp(toks[i], cur))
+						toks[k++] = toks[i];
+				tokv.n = k;
 			}
 		}
 	}
 
-	toks[j] = nil;
-	qsort(toks, j, sizeof *toks, strpcmp);
+	n = tokv.n;
+	vector_ppush(&tokv, nil);
+	toks = (char**)tokv.ary;
+	qsort(toks, n, sizeof *toks, strpcmp);
 	uniq(toks);
 
-	fmtstrinit(&fmt);
+	fmtbufinit(&fmt, tagbuf, sizeof tagbuf);
 	join(toks, "+", &fmt);
 	if(c->tagre.regex)
 		fmtprint(&fmt, "+/%s/", c->tagre.regex);
@@ -1167,9 +1261,11 @@ client_applytags(Client *c, const char *tags) {
 		fmtprint(&fmt, "-/%s/", c->tagvre.regex);
 
 	s = fmtstrflush(&fmt);
-	utflcpy(c->tags, s, sizeof c->tags);
+	client_setstring(&c->tags, &c->tagslen, s, strlen(s));
+	c->gen++;
 	changeprop_string(&c->w, "_WMII_TAGS", c->tags);
-	free(s);
+	if(s != tagbuf)
+		free(s);
 
 	free(c->retags);
 	p = view_names();
@@ -1178,14 +1274,14 @@ client_applytags(Client *c, const char *tags) {
 	c->retags = comm(CRight, toks, p);
 	free(p);
 
-	if(c->retags[0] == nil && toks[0] == nil) {
-		toks[0] = "orphans";
-		toks[1] = nil;
-	}
-
-	p = comm(~0, c->retags, toks);
+	if(c->retags[0] == nil && toks[0] == nil)
+		p = comm(~0, c->retags, orphans);
+	else
+		p = comm(~0, c->retags, toks);
 	client_setviews(c, p);
 	free(p);
+	vector_pfree(&tokv);
+	free(buf);
 	return true;
 }
 
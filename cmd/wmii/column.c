@@ -27,6 +27,7 @@ column_setmode(Area *a, const char *mode) {
 	 * change.
 	 */
 
+	a->view->gen++;
 	str = freelater(estrdup(mode));
 	old = '+';
 	while((tok = mask(&str, &add, &old))) {
@@ -105,8 +106,10 @@ void
 column_insert(Area *a, Frame *f, Frame *pos) {
 
 	f->area = a;
-	if(f->client->floating == On)
+	if(f->client->floating == On) {
 		f->client->floating = Off;
+		f->client->gen++;
+	}
 	f->screen = a->screen;
 	f->column = area_idx(a);
 	frame_insert(f, pos);
@@ -480,6 +483,7 @@ column_arrange(Area *a, bool dirty) {
 		return;
 
 	v = a->view;
+	v->gen++;
 
 	switch(a->mode) {
 	case Coldefault:
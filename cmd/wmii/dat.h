@@ -132,6 +132,7 @@ typedef struct Key Key;
 typedef struct Rule Rule;
 typedef struct Ruleset Ruleset;
 typedef struct Ruleval Ruleval;
+typedef struct Statcache Statcache;
 typedef struct Strut Strut;
 typedef struct View View;
 typedef struct WMScreen WMScreen;
@@ -154,6 +155,13 @@ struct Area {
 	Rectangle	r_old;
 };
 
+/* The size of a rendered file, valid while its owner's gen is unchanged. */
+struct Statcache {
+	ulong	gen;
+	uint	size;
+	bool	valid;
+};
+
 struct Bar {
 	Bar*	next;
 	Bar*	smaller;
@@ -165,6 +173,9 @@ struct Bar {
 	CTuple	colors;
 	Rectangle	r;
 	WMScreen*	screen;
+	ulong	gen;
+	Statcache	stat;
+	struct IxpFileId*	file;
 };
 
 struct Client {
@@ -182,10 +193,14 @@ struct Client {
 	Rectangle configr;
 	Rectangle r;
 	char**	retags;
-	char	class[256];
-	char	name[256];
-	char	props[512];
-	char	tags[256];
+	char*	class;		/* Interned, and shared between clients. */
+	char*	name;
+	char*	props;
+	char*	tags;
+	uint	classlen;
+	uint	namelen;
+	uint	propslen;
+	uint	tagslen;
 	char	proplen[PLast];
 	long	propcache[PLast];
 	long	permission;
@@ -202,6 +217,9 @@ struct Client {
 	bool	rgba;
 	bool	titleless;
 	bool	urgent;
+	ulong	gen;
+	Statcache	ctlstat;
+	struct IxpFileId*	file;
 };
 
 struct Divide {
@@ -247,10 +265,11 @@ struct Group {
 };
 
 struct Key {
-	Key*	next;
-	Key*	lnext;
-	Key*	tnext;
+	Key*	next;	/* All nodes of the binding trie */
+	Key*	lnext;	/* First strokes, i.e., the grabbed keys */
+	Key*	parent;
 	ushort	id;
+	uint	nchild;
 	char	name[128];
 	ulong	mod;
 	KeyCode	key;
@@ -299,6 +318,10 @@ struct View {
 	bool	urgent;
 	Rectangle *r;
 	Rectangle *pad;
+	ulong	gen;
+	Statcache	ctlstat;
+	Statcache	indexstat;
+	struct IxpFileId*	file;
 };
 
 #ifndef EXTERN
@@ -351,7 +374,6 @@ EXTERN Client	c_magic;
 EXTERN Client	c_root;
 EXTERN Client*	client;
 EXTERN Divide*	divs;
-EXTERN Key*	key;
 EXTERN View*	selview;
 EXTERN View*	view;
 
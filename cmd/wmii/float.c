@@ -10,8 +10,10 @@ static void float_placeframe(Frame*);
 void
 float_attach(Area *a, Frame *f) {
 
-	if(f->client->floating == Off)
+	if(f->client->floating == Off) {
 		f->client->floating = On;
+		f->client->gen++;
+	}
 
 	f->r = f->floatr;
 	float_placeframe(f);
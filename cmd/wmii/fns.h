@@ -190,6 +190,7 @@ void	fs_attach(Ixp9Req*);
 void	fs_clunk(Ixp9Req*);
 void	fs_create(Ixp9Req*);
 void	fs_flush(Ixp9Req*);
+void	fs_forget(struct IxpFileId**);
 void	fs_freefid(IxpFid*);
 void	fs_open(Ixp9Req*);
 void	fs_read(Ixp9Req*);
@@ -221,10 +222,11 @@ char*	msg_getword(IxpMsg*, char*);
 void	msg_parsecolors(IxpMsg*, CTuple*);
 char*	msg_selectarea(Area*, IxpMsg*);
 char*	msg_sendclient(View*, IxpMsg*, bool swap);
-char*	readctl_bar(Bar*);
-char*	readctl_client(Client*);
-char*	readctl_root(void);
-char*	readctl_view(View*);
+void	readctl_bar(Fmt*, Bar*);
+void	readctl_client(Fmt*, Client*);
+void	readctl_root(Fmt*);
+void	readctl_view(Fmt*, View*);
+void	readstate(Fmt*);
 Area*	strarea(View*, ulong, const char*);
 void	warning(const char*, ...);
 
@@ -270,7 +272,7 @@ void	view_detach(Frame*);
 Area*	view_findarea(View*, int, int, bool);
 void	view_focus(WMScreen*, View*);
 bool	view_fullscreen_p(View*, int);
-char*	view_index(View*);
+void	view_index(Fmt*, View*);
 void	view_init(View*, int iscreen);
 char**	view_names(void);
 uint	view_newcolwidth(View*, int, int);
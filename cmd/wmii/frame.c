@@ -340,6 +340,7 @@ frame_resize(Frame *f, Rectangle r) {
 		r.max.y = max(r.min.y+1, r.max.y);
 	}
 
+	f->view->gen++;
 	c = f->client;
 	if(c->fullscreen >= 0) {
 		f->r = screens[c->fullscreen]->r;
@@ -405,7 +406,6 @@ pushlabel(Image *img, Rectangle *rp, char *s, CTuple *col) {
 		drawstring(img, def.font, r, East,
 			   s, &col->fg);
 	}
-	free(s);
 }
 
 void
@@ -414,6 +414,7 @@ frame_draw(Frame *f) {
 	Client *c;
 	CTuple *col;
 	Image *img;
+	char buf[32];
 	char *s;
 	int n, m;
 
@@ -473,12 +474,15 @@ frame_draw(Frame *f) {
 	/* Draw count on frames in 'max' columns. */
 	if(f->area->max && !resizing) {
 		n = stack_count(f, &m);
-		pushlabel(img, &r, smprint("%d/%d", m, n), col);
+		snprint(buf, sizeof buf, "%d/%d", m, n);
+		pushlabel(img, &r, buf, col);
 	}
 
 	/* Label clients with extra tags. */
-	if((s = client_extratags(c)))
+	if((s = client_extratags(c))) {
 		pushlabel(img, &r, s, col);
+		free(s);
+	}
 
 	if(f->area->floating)  /* Make sure floating clients have room for their indicators. */
 		r.max.x -= f->grabbox.max.x;
@@ -597,6 +601,7 @@ frame_focus(Frame *f) {
 
 	old_f = old_a->sel;
 	a->sel = f;
+	v->gen++;
 
 	if(a != old_a)
 		area_focus(f->area);
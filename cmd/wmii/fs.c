@@ -22,6 +22,7 @@ union IxpFileIdU {
 #include <ixp_srvutil.h>
 
 static IxpPending	events;
+static IxpPending	bevents;
 static IxpPending	pdebug[NDebugOpt];
 
 /* Constants */
@@ -35,6 +36,7 @@ enum {	/* Dirs */
 	FsRoot,
 	/* Files */
 	FsFBar,
+	FsFBevent,
 	FsFCctl,
 	FsFClabel,
 	FsFColRules,
@@ -44,6 +46,7 @@ enum {	/* Dirs */
 	FsFKeys,
 	FsFRctl,
 	FsFRules,
+	FsFState,
 	FsFTctl,
 	FsFTindex,
 	FsFprops,
@@ -86,10 +89,12 @@ dirtab_root[]=	 {{".",		QTDIR,		FsRoot,		0500|DMDIR },
 		  {"client",	QTDIR,		FsDClients,	0500|DMDIR },
 		  {"tag",	QTDIR,		FsDTags,	0500|DMDIR },
 		  {"ctl",	QTAPPEND,	FsFRctl,	0600|DMAPPEND },
+		  {"bevent",	QTFILE,		FsFBevent,	0400 },
 		  {"colrules",	QTFILE,		FsFColRules,	0600 },
 		  {"event",	QTFILE,		FsFEvent,	0600 },
 		  {"keys",	QTFILE,		FsFKeys,	0600 },
 		  {"rules",	QTFILE,		FsFRules,	0600 },
+		  {"state",	QTFILE,		FsFState,	0400 },
 		  {nil}},
 dirtab_clients[]={{".",		QTDIR,		FsDClients,	0500|DMDIR },
 		  {"",		QTDIR,		FsDClient,	0500|DMDIR },
@@ -123,7 +128,7 @@ static IxpDirtab* dirtab[] = {
 	[FsDTag] = dirtab_tag,
 };
 typedef char* (*MsgFunc)(void*, IxpMsg*);
-typedef char* (*BufFunc)(void*);
+typedef void (*BufFunc)(Fmt*, void*);
 
 typedef struct ActionTab ActionTab;
 static struct ActionTab {
@@ -131,31 +136,280 @@ static struct ActionTab {
 	BufFunc		read;
 	size_t		buffer;
 	size_t		size;
-	int		max;
 } actiontab[] = {
 	[FsFBar]      = { .msg = (MsgFunc)message_bar,          .read = (BufFunc)readctl_bar },
 	[FsFCctl]     = { .msg = (MsgFunc)message_client,     	.read = (BufFunc)readctl_client },
 	[FsFRctl]     = { .msg = (MsgFunc)message_root,       	.read = (BufFunc)readctl_root },
 	[FsFTctl]     = { .msg = (MsgFunc)message_view,       	.read = (BufFunc)readctl_view },
 	[FsFTindex]   = { .msg = (MsgFunc)0,		    	.read = (BufFunc)view_index },
+	[FsFState]    = { .msg = (MsgFunc)0,			.read = (BufFunc)readstate },
 	[FsFColRules] = { .buffer = offsetof(Ruleset, string),	.size = offsetof(Ruleset, size) },
 	[FsFKeys]     = { .buffer = offsetof(Defs, keys),	.size = offsetof(Defs, keyssz) },
 	[FsFRules]    = { .buffer = offsetof(Ruleset, string), 	.size = offsetof(Ruleset, size) },
-	[FsFClabel]   = { .buffer = offsetof(Client, name),	.max = sizeof ((Client*)0)->name },
-	[FsFCtags]    = { .buffer = offsetof(Client, tags),   	.max = sizeof ((Client*)0)->tags },
-	[FsFprops]    = { .buffer = offsetof(Client, props),  	.max = sizeof ((Client*)0)->props },
+	[FsFClabel]   = { .buffer = offsetof(Client, name),	.size = offsetof(Client, namelen) },
+	[FsFCtags]    = { .buffer = offsetof(Client, tags),   	.size = offsetof(Client, tagslen) },
+	[FsFprops]    = { .buffer = offsetof(Client, props),  	.size = offsetof(Client, propslen) },
 };
 
+/*
+ * Binary event records, as read from /bevent. The type of an event is
+ * its index in this table, or 0 if it isn't listed. Entries must only
+ * ever be appended.
+ */
+static char* eventtypes[] = {
+	"",
+	"AreaAttach",
+	"AreaDetach",
+	"AreaFocus",
+	"ClientClick",
+	"ClientFocus",
+	"ClientMouseDown",
+	"CreateClient",
+	"CreateColumn",
+	"CreateTag",
+	"DestroyArea",
+	"DestroyClient",
+	"DestroyTag",
+	"FocusTag",
+	"Fullscreen",
+	"Key",
+	"LeftBarClick",
+	"LeftBarDND",
+	"LeftBarMouseDown",
+	"NotUrgent",
+	"NotUrgentTag",
+	"Quit",
+	"RightBarClick",
+	"RightBarDND",
+	"RightBarMouseDown",
+	"ScreenChange",
+	"UnfocusTag",
+	"Unresponsive",
+	"Urgent",
+	"UrgentTag",
+	"ViewAttach",
+	"ViewDetach",
+	"Warning",
+};
+
+enum {
+	NEventField = 32,
+};
+
+static ulong	eventseq;
+
+static bool
+pending_p(IxpPending *p) {
+	return p->fids.next && p->fids.next != &p->fids;
+}
+
+/* Returns the verb of fmt if it consists of a single conversion. */
+static int
+fmtverb(const char *fmt) {
+	int n;
+
+	n = strlen(fmt);
+	if(n < 2 || fmt[0] != '%' || strspn(fmt + 1, "#+- .*0123456789hlu,") != n - 2)
+		return 0;
+	return fmt[n - 1];
+}
+
+/*
+ * size[4] type[2] seq[4] nsec[8] nfield[2] nfield*(verb[1] len[2] data[len])
+ *
+ * The first field is always the event's name, and verb is the format
+ * verb which produced each field, or 's' for literal text.
+ */
+static void
+bevent_write(char **field, int *len, char *verb, int n) {
+	IxpMsg m;
+	uvlong time;
+	uint size, seq;
+	ushort type, nfield, flen;
+	uchar c;
+	int i;
+
+	size = 4 + 2 + 4 + 8 + 2;
+	for(i=0; i < n; i++) {
+		len[i] = min(len[i], 0xffff);
+		size += 1 + 2 + len[i];
+	}
+
+	type = 0;
+	for(i=1; n && i < nelem(eventtypes); i++)
+		if(len[0] == strlen(eventtypes[i]) && !memcmp(field[0], eventtypes[i], len[0])) {
+			type = i;
+			break;
+		}
+
+	seq = eventseq;
+	time = nsec();
+	nfield = n;
+	m = ixp_message(emalloc(size), size, MsgPack);
+	ixp_pu32(&m, &size);
+	ixp_pu16(&m, &type);
+	ixp_pu32(&m, &seq);
+	ixp_pu64(&m, &time);
+	ixp_pu16(&m, &nfield);
+	for(i=0; i < n; i++) {
+		c = verb[i];
+		flen = len[i];
+		ixp_pu8(&m, &c);
+		ixp_pu16(&m, &flen);
+		ixp_pdata(&m, &field[i], flen);
+	}
+	ixp_pending_write(&bevents, m.data, size);
+	free(m.data);
+}
+
+/*
+ * Each token of the format is formatted on its own, so that arguments
+ * containing spaces remain a single field. A format consisting of a
+ * lone conversion, such as that of events written to /event, carries
+ * free-form text, which is split into lines and words instead.
+ */
+static void
+bevent(const char *format, va_list ap) {
+	Fmt f;
+	char fmt[256], buf[512];
+	char *tok[NEventField], *field[NEventField];
+	char verb[NEventField];
+	int off[NEventField + 1], len[NEventField];
+	char *s, *line, *next;
+	int i, n;
+
+	utflcpy(fmt, format, sizeof fmt);
+	n = stokenize(tok, nelem(tok), fmt, " \n");
+
+	fmtbufinit(&f, buf, sizeof buf);
+	va_copy(f.args, ap);
+	for(i=0; i < n; i++) {
+		off[i] = f.nfmt;
+		dofmt(&f, tok[i]);
+		verb[i] = fmtverb(tok[i]);
+		if(verb[i] == 0)
+			verb[i] = 's';
+	}
+	off[n] = f.nfmt;
+	va_end(f.args);
+	s = fmtstrflush(&f);
+	if(s == nil)
+		return;
+
+	if(n == 1 && fmtverb(tok[0])) {
+		for(line=s; line; line=next) {
+			if((next = strchr(line, '\n')))
+				*next++ = '\0';
+			n = stokenize(field, nelem(field), line, " \t");
+			for(i=0; i < n; i++) {
+				len[i] = strlen(field[i]);
+				verb[i] = 's';
+			}
+			if(n)
+				bevent_write(field, len, verb, n);
+		}
+	}else {
+		for(i=0; i < n; i++) {
+			field[i] = s + off[i];
+			len[i] = off[i + 1] - off[i];
+		}
+		bevent_write(field, len, verb, n);
+	}
+	if(s != buf)
+		free(s);
+}
+
 void
 event(const char *format, ...) {
+	Fmt f;
 	va_list ap;
+	char buf[512];
+	char *s;
 
-	va_start(ap, format);
-	vsnprint(buffer, sizeof buffer, format, ap);
-	va_end(ap);
+	/* Only render the formats which someone is listening for. */
+	if(pending_p(&events) || (debugflag|debugfile) & DEvents) {
+		fmtbufinit(&f, buf, sizeof buf);
+		va_start(ap, format);
+		fmtvprint(&f, format, ap);
+		va_end(ap);
+		s = fmtstrflush(&f);
+
+		if(s) {
+			ixp_pending_write(&events, s, strlen(s));
+			Dprint(DEvents, "%s", s);
+			if(s != buf)
+				free(s);
+		}
+	}
+	if(pending_p(&bevents)) {
+		va_start(ap, format);
+		bevent(format, ap);
+		va_end(ap);
+	}
+	eventseq++;
+}
+
+/*
+ * Files produced by a renderer are rendered once per fid, on its first
+ * stat or read, into a growable string which is kept until the fid is
+ * written to or clunked. Large files are thus never truncated, and
+ * successive reads of a fid see a consistent snapshot.
+ */
+typedef struct Render Render;
+struct Render {
+	char*	data;
+	uint	size;
+};
+
+static MapEnt*	rbucket[137];
+static Map	rendermap = { rbucket, nelem(rbucket) };
+
+static bool
+render_file(IxpFileId *f, Render *rb) {
+	ActionTab *t;
+	Fmt fmt;
 
-	ixp_pending_write(&events, buffer, strlen(buffer));
-	Dprint(DEvents, "%s", buffer);
+	if(f->tab.type >= nelem(actiontab))
+		return false;
+	t = &actiontab[f->tab.type];
+	if(t->read == nil)
+		return false;
+
+	rb->data = nil;
+	rb->size = 0;
+	if(fmtstrinit(&fmt) == 0) {
+		t->read(&fmt, f->p.ref);
+		rb->size = fmt.nfmt;
+		rb->data = fmtstrflush(&fmt);
+	}
+	return true;
+}
+
+static Render*
+render(IxpFid *fid) {
+	Render *rb, tmp;
+	void **e;
+
+	e = map_get(&rendermap, (ulong)(uintptr_t)fid, false);
+	if(e)
+		return *e;
+	if(!render_file(fid->aux, &tmp))
+		return nil;
+	rb = emalloc(sizeof *rb);
+	*rb = tmp;
+	*map_get(&rendermap, (ulong)(uintptr_t)fid, true) = rb;
+	return rb;
+}
+
+static void
+render_free(IxpFid *fid) {
+	Render *rb;
+
+	rb = map_rm(&rendermap, (ulong)(uintptr_t)fid);
+	if(rb) {
+		free(rb->data);
+		free(rb);
+	}
 }
 
 static int dflags;
@@ -168,6 +422,8 @@ setdebug(int flag) {
 
 void
 vdebug(int flag, const char *fmt, va_list ap) {
+	Fmt f;
+	char buf[512];
 	char *s;
 
 	if(flag == 0)
@@ -176,9 +432,14 @@ vdebug(int flag, const char *fmt, va_list ap) {
 	if(!((debugflag|debugfile) & flag))
 		return;
 
-	s = vsmprint(fmt, ap);
+	fmtbufinit(&f, buf, sizeof buf);
+	fmtvprint(&f, fmt, ap);
+	s = fmtstrflush(&f);
+	if(s == nil)
+		return;
 	dwrite(flag, s, strlen(s), false);
-	free(s);
+	if(s != buf)
+		free(s);
 }
 
 void
@@ -209,7 +470,7 @@ dwrite(int flag, void *buf, int n, bool always) {
 static uint	fs_size(IxpFileId*);
 
 static void
-dostat(IxpStat *s, IxpFileId *f) {
+statfile(IxpStat *s, IxpFileId *f) {
 	s->type = 0;
 	s->dev = 0;
 	s->qid.path = QID(f->tab.type, f->id);
@@ -218,13 +479,84 @@ dostat(IxpStat *s, IxpFileId *f) {
 	s->mode = f->tab.perm;
 	s->atime = time(nil);
 	s->mtime = s->atime;
-	s->length = fs_size(f);;
+	s->length = 0;
 	s->name = f->tab.name;
 	s->uid = user;
 	s->gid = user;
 	s->muid = user;
 }
 
+static void
+dostat(IxpStat *s, IxpFileId *f) {
+	statfile(s, f);
+	s->length = fs_size(f);
+}
+
+/*
+ * The sizes of the rendered files of clients, views, and bars are
+ * cached along with the generation of their owner, which is bumped
+ * whenever anything they render changes.
+ */
+static Statcache*
+statcache(IxpFileId *f, ulong *gen) {
+	switch(f->tab.type) {
+	case FsFBar:
+		*gen = f->p.bar->gen;
+		return &f->p.bar->stat;
+	case FsFCctl:
+		*gen = f->p.client->gen;
+		return &f->p.client->ctlstat;
+	case FsFTctl:
+		*gen = f->p.view->gen;
+		return &f->p.view->ctlstat;
+	case FsFTindex:
+		*gen = f->p.view->gen;
+		return &f->p.view->indexstat;
+	}
+	return nil;
+}
+
+static void
+touch(IxpFileId *f) {
+	switch(f->tab.type) {
+	case FsFBar:
+		f->p.bar->gen++;
+		break;
+	case FsFCctl:
+		f->p.client->gen++;
+		break;
+	case FsFTctl:
+		f->p.view->gen++;
+		break;
+	}
+}
+
+/*
+ * The entries of /client, /tag, and the bar directories are listed far
+ * more often than they come and go, so each object keeps its own entry,
+ * which is handed out with an extra reference whenever it's listed.
+ */
+static IxpFileId*
+cachefile(IxpDirtab *dir, char *name, uint id) {
+	IxpFileId *f;
+
+	f = ixp_srv_getfile();
+	f->tab = *dir;
+	f->tab.name = estrdup(name);
+	f->id = id;
+	f->volatil = true;
+	return f;
+}
+
+void
+fs_forget(IxpFileId **fp) {
+
+	if(*fp) {
+		ixp_srv_freefile(*fp);
+		*fp = nil;
+	}
+}
+
 /*
  * All lookups and directory organization should be performed through
  * lookup_file, mostly through the dirtab[] tree.
@@ -255,6 +587,13 @@ lookup_file(IxpFileId *parent, char *name)
 			last = &file->next;       \
 			file->tab = *dir;         \
 			file->tab.name = estrdup(nam)
+#		define push_cached(ref, nam, id_) \
+			if(ref == nil)            \
+				ref = cachefile(dir, nam, id_); \
+			file = ref;               \
+			file->nref++;             \
+			*last = file;             \
+			last = &file->next
 		/* Dynamic dirs */
 		if(dir->name[0] == '\0') {
 			switch(parent->tab.type) {
@@ -275,13 +614,16 @@ lookup_file(IxpFileId *parent, char *name)
 						goto NextItem;
 				}
 				for(c=client; c; c=c->next) {
-					if(!name || c->w.xid == id) {
+					if(!name) {
+						push_cached(c->file, sxprint("%#C", c), c->w.xid);
+						file->p.client = c;
+						file->index = c->w.xid;
+					}else if(c->w.xid == id) {
 						push_file(sxprint("%#C", c), c->w.xid, true);
 						file->p.client = c;
 						file->index = c->w.xid;
 						assert(file->tab.name);
-						if(name)
-							goto LastItem;
+						goto LastItem;
 					}
 				}
 				break;
@@ -303,21 +645,25 @@ lookup_file(IxpFileId *parent, char *name)
 						goto LastItem;
 				}
 				for(v=view; v; v=v->next) {
-					if(!name || !strcmp(name, v->name)) {
+					if(!name) {
+						push_cached(v->file, v->name, v->id);
+						file->p.view = v;
+					}else if(!strcmp(name, v->name)) {
 						push_file(v->name, v->id, true);
 						file->p.view = v;
-						if(name)
-							goto LastItem;
+						goto LastItem;
 					}
 				}
 				break;
 			case FsDBars:
 				for(b=*parent->p.bar_p; b; b=b->next) {
-					if(!name || !strcmp(name, b->name)) {
+					if(!name) {
+						push_cached(b->file, b->name, b->id);
+						file->p.bar = b;
+					}else if(!strcmp(name, b->name)) {
 						push_file(b->name, b->id, true);
 						file->p.bar = b;
-						if(name)
-							goto LastItem;
+						goto LastItem;
 					}
 				}
 				break;
@@ -352,6 +698,7 @@ lookup_file(IxpFileId *parent, char *name)
 	NextItem:
 		continue;
 #		undef push_file
+#		undef push_cached
 	}
 LastItem:
 	*last = nil;
@@ -382,17 +729,26 @@ fs_walk(Ixp9Req *r) {
 static uint
 fs_size(IxpFileId *f) {
 	ActionTab *t;
+	Statcache *sc;
+	Render rb;
+	ulong gen;
 
+	SET(gen);
 	t = &actiontab[f->tab.type];
 	if(f->tab.type < nelem(actiontab))
 		if(t->size)
-			return structmember(f->p.ref, int, t->size);
-		else if(t->buffer && t->max)
-			return strlen(structptr(f->p.ref, char, t->buffer));
-		else if(t->buffer)
-			return strlen(structmember(f->p.ref, char*, t->buffer));
-		else if(t->read)
-			return strlen(t->read(f->p.ref));
+			return structmember(f->p.ref, uint, t->size);
+		else if((sc = statcache(f, &gen)) && sc->valid && sc->gen == gen)
+			return sc->size;
+		else if(render_file(f, &rb)) {
+			free(rb.data);
+			if(sc) {
+				sc->gen = gen;
+				sc->size = rb.size;
+				sc->valid = true;
+			}
+			return rb.size;
+		}
 	return 0;
 }
 
@@ -403,6 +759,7 @@ fs_stat(Ixp9Req *r) {
 	int size;
 	char *buf;
 	IxpFileId *f;
+	Render *rb;
 
 	f = r->fid->aux;
 
@@ -411,7 +768,11 @@ fs_stat(Ixp9Req *r) {
 		return;
 	}
 
-	dostat(&s, f);
+	statfile(&s, f);
+	if((rb = render(r->fid)))
+		s.length = rb->size;
+	else
+		s.length = fs_size(f);
 	size = ixp_sizeof_stat(&s);
 	r->ofcall.rstat.nstat = size;
 	buf = emallocz(size);
@@ -428,6 +789,7 @@ fs_read(Ixp9Req *r) {
 	char *buf;
 	IxpFileId *f;
 	ActionTab *t;
+	Render *rb;
 	int n, found;
 
 	f = r->fid->aux;
@@ -447,17 +809,17 @@ fs_read(Ixp9Req *r) {
 			ixp_pending_respond(r);
 			return;
 		}
+		if((rb = render(r->fid))) {
+			ixp_srv_readbuf(r, rb->data, rb->size);
+			ixp_respond(r, nil);
+			return;
+		}
 		t = &actiontab[f->tab.type];
 		if(f->tab.type < nelem(actiontab)) {
-			if(t->read)
-				buf = t->read(f->p.ref);
-			else if(t->buffer && t->max)
-				buf = structptr(f->p.ref, char, t->buffer);
-			else if(t->buffer)
-				buf = structmember(f->p.ref, char*, t->buffer);
-			else
+			if(!t->buffer)
 				goto done;
-			n = t->size ? structmember(f->p.ref, int, t->size) : strlen(buf);
+			buf = structmember(f->p.ref, char*, t->buffer);
+			n = structmember(f->p.ref, uint, t->size);
 			ixp_srv_readbuf(r, buf, n);
 			ixp_respond(r, nil);
 			found++;
@@ -492,6 +854,8 @@ fs_write(Ixp9Req *r) {
 		ixp_respond(r, Enofile);
 		return;
 	}
+	/* Subsequent reads should reflect the change. */
+	render_free(r->fid);
 
 	switch(f->tab.type) {
 	case FsFCtags:
@@ -510,18 +874,13 @@ fs_write(Ixp9Req *r) {
 	t = &actiontab[f->tab.type];
 	if(f->tab.type < nelem(actiontab)) {
 		if(t->msg) {
+			touch(f);
 			errstr = ixp_srv_writectl(r, t->msg);
 			r->ofcall.io.count = r->ifcall.io.count;
 		}
-		else if(t->buffer && t->max)
-			ixp_srv_writebuf(r, (char*[]){ structptr(f->p.ref, char, t->buffer) },
-					 t->size ? structptr(f->p.ref, uint, t->size)
-					         : (uint[]){ strlen(structptr(f->p.ref, char, t->buffer)) },
-					 t->max);
 		else if(t->buffer)
 			ixp_srv_writebuf(r, structptr(f->p.ref, char*, t->buffer),
-					 t->size ? structptr(f->p.ref, uint, t->size) : nil,
-					 t->max);
+					 structptr(f->p.ref, uint, t->size), 0);
 		else
 			goto done;
 		ixp_respond(r, errstr);
@@ -568,6 +927,9 @@ fs_open(Ixp9Req *r) {
 	case FsFEvent:
 		ixp_pending_pushfid(&events, r->fid);
 		break;
+	case FsFBevent:
+		ixp_pending_pushfid(&bevents, r->fid);
+		break;
 	case FsFDebug:
 		ixp_pending_pushfid(pdebug+f->id, r->fid);
 		debugfile |= 1<<f->id;
@@ -689,6 +1051,7 @@ void
 fs_freefid(IxpFid *f) {
 	IxpFileId *id, *tid;
 
+	render_free(f);
 	tid = f->aux;
 	while((id = tid)) {
 		tid = id->next;
@@ -6,15 +6,33 @@
 #include <X11/keysym.h>
 #include "fns.h"
 
-static void
-freekey(Key *k) {
-	Key *n;
+/*
+ * Bindings are kept in a trie, one node per stroke, indexed by
+ * (parent, modifiers, keycode) in a hash table. The first strokes of
+ * each trie own the X key grabs. Two tries are kept so that
+ * update_keys can build the new one beside the old and only grab or
+ * ungrab the strokes which differ between them.
+ */
+enum {
+	NKeyHash = 137,
+	NKeyStroke = 8,
+};
 
-	while((n = k)) {
-		k = k->next;
-		free(n);
-	}
-}
+typedef struct Keymap Keymap;
+struct Keymap {
+	Map	map;
+	MapEnt*	bucket[NKeyHash];
+	Key*	all;
+	Key*	first;
+	ushort	nid;
+	uint	numlock;
+};
+
+static Keymap	keymaps[2];
+static Keymap*	keymap = &keymaps[0];
+
+#define strokeid(parent, mod, code) \
+	((ulong)(parent) << 16 | ((mod) & 0xff) << 8 | (code))
 
 static void
 _grab(XWindow w, int keycode, uint mod) {
@@ -23,77 +41,108 @@ _grab(XWindow w, int keycode, uint mod) {
 }
 
 static void
-grabkey(Key *k) {
+grabkey(Key *k, uint numlock) {
 	_grab(scr.root.xid, k->key, k->mod);
 	_grab(scr.root.xid, k->key, k->mod | LockMask);
-	if(numlock_mask) {
-		_grab(scr.root.xid, k->key, k->mod | numlock_mask);
-		_grab(scr.root.xid, k->key, k->mod | numlock_mask | LockMask);
+	if(numlock) {
+		_grab(scr.root.xid, k->key, k->mod | numlock);
+		_grab(scr.root.xid, k->key, k->mod | numlock | LockMask);
 	}
 }
 
 static void
-ungrabkey(Key *k) {
+ungrabkey(Key *k, uint numlock) {
 	XUngrabKey(display, k->key, k->mod, scr.root.xid);
 	XUngrabKey(display, k->key, k->mod | LockMask, scr.root.xid);
-	if(numlock_mask) {
-		XUngrabKey(display, k->key, k->mod | numlock_mask, scr.root.xid);
-		XUngrabKey(display, k->key, k->mod | numlock_mask | LockMask, scr.root.xid);
+	if(numlock) {
+		XUngrabKey(display, k->key, k->mod | numlock, scr.root.xid);
+		XUngrabKey(display, k->key, k->mod | numlock | LockMask, scr.root.xid);
 	}
 }
 
 static Key*
-name2key(const char *name) {
-	Key *k;
+keymap_lookup(Keymap *m, Key *parent, ulong mod, KeyCode code) {
+	void **e;
 
-	for(k=key; k; k=k->lnext)
-		if(!strcmp(k->name, name))
-			return k;
-	return nil;
+	if(m->map.bucket == nil)
+		return nil;
+	e = map_get(&m->map, strokeid(parent ? parent->id : 0, mod, code), false);
+	return e ? *e : nil;
 }
 
 static Key*
-getkey(const char *name) {
-	Key *k, *r;
+keymap_add(Keymap *m, Key *parent, ulong mod, KeyCode code) {
+	Key *k;
+	void **e;
+
+	e = map_get(&m->map, strokeid(parent ? parent->id : 0, mod, code), true);
+	if(*e)
+		return *e;
+
+	k = emallocz(sizeof *k);
+	k->id = ++m->nid;
+	k->parent = parent;
+	k->mod = mod;
+	k->key = code;
+	k->next = m->all;
+	m->all = k;
+	if(parent)
+		parent->nchild++;
+	else {
+		k->lnext = m->first;
+		m->first = k;
+	}
+	*e = k;
+	return k;
+}
+
+static void
+keymap_clear(Keymap *m) {
+	Key *k;
+
+	m->map.bucket = m->bucket;
+	m->map.nhash = nelem(m->bucket);
+	/* Children always precede their parents in m->all. */
+	while((k = m->all)) {
+		m->all = k->next;
+		map_rm(&m->map, strokeid(k->parent ? k->parent->id : 0, k->mod, k->key));
+		free(k);
+	}
+	assert(m->map.nmemb == 0);
+	m->first = nil;
+	m->nid = 0;
+}
+
+static bool
+keymap_parse(Keymap *m, const char *name) {
+	Key *k;
 	char buf[128];
-	char *seq[8];
+	char *seq[NKeyStroke];
 	char *kstr;
+	ulong mod[NKeyStroke];
+	KeyCode code[NKeyStroke];
 	int mask;
 	uint i, toks;
-	static ushort id = 1;
-
-	r = nil;
 
-	if((k = name2key(name))) {
-		ungrabkey(k);
-		return k;
-	}
 	utflcpy(buf, name, sizeof buf);
-	toks = tokenize(seq, 8, buf, ',');
+	toks = tokenize(seq, nelem(seq), buf, ',');
+	if(toks == 0 || m->nid > USHRT_MAX - toks)
+		return false;
 	for(i = 0; i < toks; i++) {
-		if(!k)
-			r = k = emallocz(sizeof *k);
-		else {
-			k->next = emallocz(sizeof *k);
-			k = k->next;
-		}
-		utflcpy(k->name, name, sizeof k->name);
+		code[i] = 0;
 		if(parsekey(seq[i], &mask, &kstr)) {
-			k->key = keycode(kstr);
-			k->mod = mask;
+			code[i] = keycode(kstr);
+			mod[i] = mask;
 		}
-		if(k->key == 0) {
-			freekey(r);
-			return nil;
-		}
-	}
-	if(r) {
-		r->id = id++;
-		r->lnext = key;
-		key = r;
+		if(code[i] == 0)
+			return false;
 	}
 
-	return r;
+	k = nil;
+	for(i = 0; i < toks; i++)
+		k = keymap_add(m, k, mod[i], code[i]);
+	utflcpy(k->name, name, sizeof k->name);
+	return true;
 }
 
 static void
@@ -132,24 +181,6 @@ fake_keypress(ulong mod, KeyCode key) {
 	sync();
 }
 
-static Key *
-match_keys(Key *k, ulong mod, KeyCode keycode, bool seq) {
-	Key *ret, *next;
-	int i; /* shut up ken */
-
-	ret = nil;
-	for(next = k->tnext; k; i = (k=next) && (next=k->tnext)) {
-		if(seq)
-			k = k->next;
-		if(k && (k->mod == mod) && (k->key == keycode)) {
-			k->tnext = ret;
-			ret = k;
-		}
-	}
-	USED(i);
-	return ret;
-}
-
 static void
 kpress_seq(XWindow w, Key *done) {
 	ulong mod;
@@ -157,13 +188,13 @@ kpress_seq(XWindow w, Key *done) {
 	Key *found;
 
 	next_keystroke(&mod, &key);
-	found = match_keys(done, mod, key, true);
+	found = keymap_lookup(keymap, done, mod, key);
 	if((done->mod == mod) && (done->key == key))
 		fake_keypress(mod, key); /* double key */
 	else {
 		if(!found)
 			XBell(display, 0);
-		else if(!found->tnext && !found->next)
+		else if(!found->nchild)
 			event("Key %s\n", found->name);
 		else
 			kpress_seq(w, found);
@@ -172,15 +203,12 @@ kpress_seq(XWindow w, Key *done) {
 
 void
 kpress(XWindow w, ulong mod, KeyCode keycode) {
-	Key *k, *found;
-
-	for(k=key; k; k=k->lnext)
-		 k->tnext = k->lnext;
+	Key *found;
 
-	found = match_keys(key, mod, keycode, false);
+	found = keymap_lookup(keymap, nil, mod, keycode);
 	if(!found) /* grabbed but not found */
 		XBell(display, 0);
-	else if(!found->tnext && !found->next)
+	else if(!found->nchild)
 		event("Key %s\n", found->name);
 	else {
 		XGrabKeyboard(display, w, true, GrabModeAsync, GrabModeAsync, CurrentTime);
@@ -192,28 +220,38 @@ kpress(XWindow w, ulong mod, KeyCode keycode) {
 
 void
 update_keys(void) {
+	Keymap *old, *new;
 	Key *k;
 	char *l, *p;
+	bool regrab;
+
+	old = keymap;
+	new = &keymaps[old == &keymaps[0]];
+	keymap_clear(new);
 
 	numlock_mask = numlockmask();
 	valid_mask = 0xff & ~(numlock_mask | LockMask);
-	while((k = key)) {
-		key = key->lnext;
-		ungrabkey(k);
-		freekey(k);
-	}
 	for(l = p = def.keys; p && *p; p++) {
 		if(*p == '\n') {
 			*p = 0;
-			if((k = getkey(l)))
-				grabkey(k);
+			keymap_parse(new, l);
 			*p = '\n';
 			l = p + 1;
 		}
 	}
-	if(l < p && strlen(l)) {
-		if((k = getkey(l)))
-			grabkey(k);
-	}
-}
+	if(l < p && strlen(l))
+		keymap_parse(new, l);
 
+	/* Only touch the grabs which have changed. */
+	regrab = old->numlock != numlock_mask;
+	for(k=old->first; k; k=k->lnext)
+		if(regrab || !keymap_lookup(new, nil, k->mod, k->key))
+			ungrabkey(k, old->numlock);
+	for(k=new->first; k; k=k->lnext)
+		if(regrab || !keymap_lookup(old, nil, k->mod, k->key))
+			grabkey(k, numlock_mask);
+
+	new->numlock = numlock_mask;
+	keymap = new;
+	keymap_clear(old);
+}
@@ -478,12 +478,10 @@ getframe(View *v, int scrn, IxpMsg *m) {
 	return f;
 }
 
-char*
-readctl_bar(Bar *b) {
-	bufclear();
-	bufprint("colors %s\n", b->colors.colstr);
-	bufprint("label %s\n", b->text);
-	return buffer;
+void
+readctl_bar(Fmt *f, Bar *b) {
+	fmtprint(f, "colors %s\n", b->colors.colstr);
+	fmtprint(f, "label %s\n", b->text);
 }
 
 char*
@@ -503,22 +501,20 @@ message_bar(Bar *b, IxpMsg *m) {
 	return nil;
 }
 
-char*
-readctl_client(Client *c) {
-	bufclear();
-	bufprint("%#C\n", c);
-	bufprint("allow %M\n", (Mask){&c->permission, permtab});
-	bufprint("floating %s\n", floatingtab[c->floating + 1]);
+void
+readctl_client(Fmt *f, Client *c) {
+	fmtprint(f, "%#C\n", c);
+	fmtprint(f, "allow %M\n", (Mask){&c->permission, permtab});
+	fmtprint(f, "floating %s\n", floatingtab[c->floating + 1]);
 	if(c->fullscreen >= 0)
-		bufprint("fullscreen %d\n", c->fullscreen);
+		fmtprint(f, "fullscreen %d\n", c->fullscreen);
 	else
-		bufprint("fullscreen off\n");
-	bufprint("group %#ulx\n", c->group ? c->group->leader : 0);
+		fmtprint(f, "fullscreen off\n");
+	fmtprint(f, "group %#ulx\n", c->group ? c->group->leader : 0);
 	if(c->pid)
-		bufprint("pid %d\n", c->pid);
-	bufprint("tags %s\n", c->tags);
-	bufprint("urgent %s\n", TOGGLE(c->urgent));
-	return buffer;
+		fmtprint(f, "pid %d\n", c->pid);
+	fmtprint(f, "tags %s\n", c->tags);
+	fmtprint(f, "urgent %s\n", TOGGLE(c->urgent));
 }
 
 char*
@@ -705,26 +701,64 @@ message_root(void *p, IxpMsg *m) {
 	return ret;
 }
 
-char*
-readctl_root(void) {
+void
+readctl_root(Fmt *f) {
 	fmtinstall('M', Mfmt);
-	bufclear();
-	bufprint("bar on %s\n", barpostab[screen->barpos]);
-	bufprint("border %d\n", def.border);
-	bufprint("colmode %s\n", modes[def.colmode]);
+	fmtprint(f, "bar on %s\n", barpostab[screen->barpos]);
+	fmtprint(f, "border %d\n", def.border);
+	fmtprint(f, "colmode %s\n", modes[def.colmode]);
 	if(debugflag)
-		bufprint("debug %M\n", (Mask){&debugflag, debugtab});
+		fmtprint(f, "debug %M\n", (Mask){&debugflag, debugtab});
 	if(debugfile)
-		bufprint("debugfile %M", (Mask){&debugfile, debugtab});
-	bufprint("focuscolors %s\n", def.focuscolor.colstr);
-	bufprint("font %s\n", def.font->name);
-	bufprint("fontpad %d %d %d %d\n", def.font->pad.min.x, def.font->pad.max.x,
+		fmtprint(f, "debugfile %M", (Mask){&debugfile, debugtab});
+	fmtprint(f, "focuscolors %s\n", def.focuscolor.colstr);
+	fmtprint(f, "font %s\n", def.font->name);
+	fmtprint(f, "fontpad %d %d %d %d\n", def.font->pad.min.x, def.font->pad.max.x,
 		 def.font->pad.max.y, def.font->pad.min.y);
-	bufprint("grabmod %s\n", (Mask){&def.mod, modkey_names});
-	bufprint("incmode %s\n", incmodetab[def.incmode]);
-	bufprint("normcolors %s\n", def.normcolor.colstr);
-	bufprint("view %s\n", selview->name);
-	return buffer;
+	fmtprint(f, "grabmod %s\n", (Mask){&def.mod, modkey_names});
+	fmtprint(f, "incmode %s\n", incmodetab[def.incmode]);
+	fmtprint(f, "normcolors %s\n", def.normcolor.colstr);
+	fmtprint(f, "view %s\n", selview->name);
+}
+
+/* A complete snapshot of the window manager's state, for /state. */
+void
+readstate(Fmt *f) {
+	Client *c;
+	Frame *fr;
+	View *v;
+	Area *a;
+	Rectangle r;
+	int s;
+
+	if(selview)
+		fmtprint(f, "select %q", selview->name);
+	if((c = selclient()))
+		fmtprint(f, " %#C", c);
+	fmtprint(f, "\n");
+
+	for(c=client; c; c=c->next) {
+		r = c->r;
+		fmtprint(f, "client %#C %d %d %d %d %q %q %q\n",
+			 c, r.min.x, r.min.y, Dx(r), Dy(r),
+			 c->tags, c->name, c->props);
+	}
+
+	for(v=view; v; v=v->next) {
+		fmtprint(f, "view %q\n", v->name);
+		foreach_area(v, s, a) {
+			r = a->r;
+			fmtprint(f, "area %q %#a %d %d %d %d %s\n",
+				 v->name, a, r.min.x, r.min.y, Dx(r), Dy(r),
+				 a->floating ? "float" : column_getmode(a));
+			for(fr=a->frame; fr; fr=fr->anext) {
+				r = fr->r;
+				fmtprint(f, "frame %q %#a %#C %d %d %d %d\n",
+					 v->name, a, fr->client,
+					 r.min.x, r.min.y, Dx(r), Dy(r));
+			}
+		}
+	}
 }
 
 char*
@@ -807,29 +841,27 @@ message_view(View *v, IxpMsg *m) {
 	/* not reached */
 }
 
-char*
-readctl_view(View *v) {
+void
+readctl_view(Fmt *f, View *v) {
 	Area *a;
 	int s;
 
-	bufclear();
-	bufprint("%s\n", v->name);
+	fmtprint(f, "%s\n", v->name);
 
-	bufprint("urgent %s\n", TOGGLE(v->urgent));
+	fmtprint(f, "urgent %s\n", TOGGLE(v->urgent));
 
 	/* select <area>[ <frame>] */
-	bufprint("select %a", v->sel);
+	fmtprint(f, "select %a", v->sel);
 	if(v->sel->sel)
-		bufprint(" %d", frame_idx(v->sel->sel));
-	bufprint("\n");
+		fmtprint(f, " %d", frame_idx(v->sel->sel));
+	fmtprint(f, "\n");
 
 	/* select client <client> */
 	if(v->sel->sel)
-		bufprint("select client %#C\n", v->sel->sel->client);
+		fmtprint(f, "select client %#C\n", v->sel->sel->client);
 
 	foreach_area(v, s, a)
-		bufprint("colmode %a %s\n", a, column_getmode(a));
-	return buffer;
+		fmtprint(f, "colmode %a %s\n", a, column_getmode(a));
 }
 
 static void
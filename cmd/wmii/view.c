@@ -182,6 +182,7 @@ view_destroy(View *v) {
 	free(v->areas);
 	free(v->r);
 	free(v->pad);
+	fs_forget(&v->file);
 	free(v);
 	ewmh_updateviews();
 }
@@ -379,6 +380,8 @@ view_update_urgency(View *v, char *from) {
 		      from ? from : "Unknown",
 		      v->name);
 
+	if(urgent != v->urgent)
+		v->gen++;
 	v->urgent = urgent;
 }
 
@@ -596,6 +599,7 @@ view_arrange(View *v) {
 	if(!v->firstarea)
 		return;
 
+	v->gen++;
 	view_update_rect(v);
 	for(s=0; s < nscreens; s++)
 		view_scale(v, s, Dx(v->r[s]) + Dx(v->pad[s]));
@@ -674,35 +678,33 @@ view_newcolwidth(View *v, int scrn, int num) {
 	return 0;
 }
 
-char*
-view_index(View *v) {
+void
+view_index(Fmt *fmt, View *v) {
 	Rectangle *r;
 	Frame *f;
 	Area *a;
 	int s;
 
-	bufclear();
 	foreach_area(v, s, a) {
 		if(a->floating)
-			bufprint("# %a %d %d\n", a, Dx(a->r), Dy(a->r));
+			fmtprint(fmt, "# %a %d %d\n", a, Dx(a->r), Dy(a->r));
 		else
-			bufprint("# %a %d %d\n", a, a->r.min.x, Dx(a->r));
+			fmtprint(fmt, "# %a %d %d\n", a, a->r.min.x, Dx(a->r));
 
 		for(f=a->frame; f; f=f->anext) {
 			r = &f->r;
 			if(a->floating)
-				bufprint("%a %#C %d %d %d %d %s\n",
+				fmtprint(fmt, "%a %#C %d %d %d %d %s\n",
 						a, f->client,
 						r->min.x, r->min.y,
 						Dx(*r), Dy(*r),
 						f->client->props);
 			else
-				bufprint("%a %#C %d %d %s\n",
+				fmtprint(fmt, "%a %#C %d %d %s\n",
 						a, f->client,
 						r->min.y, Dy(*r),
 						f->client->props);
 		}
 	}
-	return buffer;
 }
 
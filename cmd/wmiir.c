@@ -3,10 +3,15 @@
  */
 #define IXP_NO_P9_
 #define IXP_P9_STRUCTS
+/* For openat(2) and friends, and dirent's d_type. */
+#define _DEFAULT_SOURCE
 #include <dirent.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <fnmatch.h>
 #include <limits.h>
 #include <locale.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <string.h>
 #include <sys/stat.h>
@@ -29,7 +34,10 @@ usage(void) {
 	lprint(1,
 	       "usage: %s [-a <address>] [-b] {create | ls [-dlp] | read | remove | write} <file>\n"
 	       "       %s [-a <address>] xwrite <file> <data>\n"
-	       "       %s -v\n", argv0, argv0, argv0);
+	       "       %s [-a <address>] [-b] batch [<file>]\n"
+	       "       %s [-a <address>] events [-i] [--] <pattern> ...\n"
+	       "       %s proglist [-c] [--] <directory> ...\n"
+	       "       %s -v\n", argv0, argv0, argv0, argv0, argv0, argv0);
 	exit(1);
 }
 
@@ -38,15 +46,35 @@ errfmt(Fmt *f) {
 	return fmtstrcpy(f, ixp_errbuf());
 }
 
+/*
+ * The length of the run of ASCII at the start of s, which reads the
+ * same in any locale and needs no conversion. Checked a word at a
+ * time.
+ */
+static int
+asciilen(char *s, int n) {
+	ulong w;
+	int i;
+
+	for(i=0; i + sizeof w <= n; i += sizeof w) {
+		memcpy(&w, s + i, sizeof w);
+		if(w & ~0UL / 0xff * 0x80)
+			break;
+	}
+	for(; i < n && !(s[i] & 0x80); i++)
+		;
+	return i;
+}
+
 static bool
 flush(IxpCFid *fid, char *in, int len, bool binary) {
 	static mbstate_t state;
 	static char buf[IXP_MAX_MSG];
 	static char *out = buf, *outend = buf + sizeof buf;
-	char *inend;
+	char *inend, *p;
 	wchar_t w;
 	Rune r;
-	int res;
+	int res, n;
 
 	if(binary)
 		return ixp_write(fid, in, len) == len;
@@ -55,7 +83,7 @@ flush(IxpCFid *fid, char *in, int len, bool binary) {
 	do {
 		if(in == nil || out + UTFmax > outend) {
 			if(ixp_write(fid, buf, out - buf) != out - buf)
-				return false;
+				goto fail;
 			out = buf;
 		}
 		if(in == nil) {
@@ -63,9 +91,21 @@ flush(IxpCFid *fid, char *in, int len, bool binary) {
 			return true;
 		}
 
+		/* Copy ASCII across in bulk, up to any NUL, which ends the input. */
+		if(mbsinit(&state) && (n = asciilen(in, min(inend - in, outend - out)))) {
+			if((p = memchr(in, '\0', n)))
+				n = p - in;
+			memcpy(out, in, n);
+			in += n;
+			out += n;
+			if(p == nil)
+				continue;
+		}
+
 		switch((res = mbrtowc(&w, in, inend - in, &state))) {
 		case -1:
-			return false;
+			ixp_werrstr("invalid multibyte sequence");
+			goto fail;
 		case 0:
 		case -2:
 			return true;
@@ -76,6 +116,12 @@ flush(IxpCFid *fid, char *in, int len, bool binary) {
 		}
 	} while(in < inend);
 	return true;
+
+fail:
+	/* Drop what's left, so that the next stream starts afresh. */
+	out = buf;
+	state = (mbstate_t){0};
+	return false;
 }
 
 static bool
@@ -115,6 +161,14 @@ unflush(int fd, char *in, int len, bool binary) {
 			return true;
 		}
 
+		if(mbsinit(&state) && (res = asciilen(in, min(n, outend - out)))) {
+			memcpy(out, in, res);
+			in += res;
+			out += res;
+			n -= res;
+			continue;
+		}
+
 		in += chartorune(&r, in);
 		n--;
 		res = wcrtomb(out, r, &state);
@@ -132,6 +186,13 @@ unflush(int fd, char *in, int len, bool binary) {
 }
 
 /* Utility Functions */
+
+/*
+ * Writes are deliberately kept one Twrite at a time. wmii acts on
+ * each write to a ctl file as it arrives, so the order of commands
+ * matters, and a failed write must stop the rest of the stream before
+ * it reaches the server.
+ */
 static void
 write_data(IxpCFid *fid, char *name, bool binary) {
 	char buf[IXP_MAX_MSG];
@@ -302,12 +363,175 @@ xremove(int argc, char *argv[]) {
 	return 0;
 }
 
-static int
-xread(int argc, char *argv[]) {
+/*
+ * The files named on the command line are fetched by a pool of
+ * threads, each with requests of its own in flight, which libixp
+ * matches to their replies by tag. Output is still written in
+ * argument order, by the main thread, and the file at its head is
+ * streamed as it's read.
+ */
+enum {
+	FetchWindow = 8,
+};
+
+enum {
+	FetchOk,
+	FetchStat,
+	FetchOpen,
+	FetchRead,
+};
+
+typedef struct Chunk Chunk;
+typedef struct Fetch Fetch;
+
+struct Chunk {
+	Chunk*	next;
+	int	n;
+	char	data[];
+};
+
+struct Fetch {
+	char*	file;
+	char*	error;
+	int	failed;
+	Chunk*	chunks;
+	Chunk**	last;
+	Stat*	stat;
+	int	nstat;
+	int	iounit;
+	bool	isdir;
+	bool	done;
+};
+
+static struct {
+	pthread_mutex_t	lock;
+	pthread_cond_t	ready;
+	Fetch*		fetch;
+	int		n;
+	int		next;
+	void		(*fn)(Fetch*);
+	pthread_t	thread[FetchWindow];
+	int		nthread;
+} fetchpool = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER };
+
+static void
+fetch_done(Fetch *f, int failed) {
+
+	pthread_mutex_lock(&fetchpool.lock);
+	if(failed) {
+		f->failed = failed;
+		f->error = estrdup(ixp_errbuf());
+	}
+	f->done = true;
+	pthread_cond_broadcast(&fetchpool.ready);
+	pthread_mutex_unlock(&fetchpool.lock);
+}
+
+static void
+fetch_push(Fetch *f, Chunk *c) {
+
+	pthread_mutex_lock(&fetchpool.lock);
+	*f->last = c;
+	f->last = &c->next;
+	pthread_cond_broadcast(&fetchpool.ready);
+	pthread_mutex_unlock(&fetchpool.lock);
+}
+
+/* Takes whatever f has read so far, waiting for some, or for the end. */
+static Chunk*
+fetch_wait(Fetch *f, bool *done) {
+	Chunk *c;
+
+	pthread_mutex_lock(&fetchpool.lock);
+	while(f->chunks == nil && !f->done)
+		pthread_cond_wait(&fetchpool.ready, &fetchpool.lock);
+	c = f->chunks;
+	f->chunks = nil;
+	f->last = &f->chunks;
+	*done = f->done;
+	pthread_mutex_unlock(&fetchpool.lock);
+	return c;
+}
+
+static void*
+fetch_worker(void *arg) {
+	Fetch *f;
+
+	USED(arg);
+	for(;;) {
+		pthread_mutex_lock(&fetchpool.lock);
+		f = nil;
+		if(fetchpool.next < fetchpool.n)
+			f = &fetchpool.fetch[fetchpool.next++];
+		pthread_mutex_unlock(&fetchpool.lock);
+		if(f == nil)
+			return nil;
+		fetchpool.fn(f);
+	}
+}
+
+static Fetch*
+fetch_start(char *argv[], int argc, void (*fn)(Fetch*)) {
+	Fetch *fetch;
+	int i;
+
+	fetch = emallocz(argc * sizeof *fetch);
+	for(i=0; i < argc; i++) {
+		fetch[i].file = argv[i];
+		fetch[i].last = &fetch[i].chunks;
+	}
+	fetchpool.fetch = fetch;
+	fetchpool.n = argc;
+	fetchpool.fn = fn;
+	for(i=0; i < min(argc, FetchWindow); i++)
+		if(pthread_create(&fetchpool.thread[i], nil, fetch_worker, nil))
+			break;
+	if((fetchpool.nthread = i) == 0)
+		fatal("can't create thread\n");
+	return fetch;
+}
+
+static void
+fetch_finish(void) {
+	int i;
+
+	for(i=0; i < fetchpool.nthread; i++)
+		pthread_join(fetchpool.thread[i], nil);
+}
+
+static void
+fetch_read(Fetch *f) {
 	IxpCFid *fid;
-	char *file, *buf;
+	Chunk *c;
 	int count;
 
+	fid = ixp_open(client, f->file, P9_OREAD);
+	if(fid == nil) {
+		fetch_done(f, FetchOpen);
+		return;
+	}
+	f->iounit = fid->iounit;
+	for(;;) {
+		c = emalloc(sizeof *c + fid->iounit);
+		c->next = nil;
+		if((count = ixp_read(fid, c->data, fid->iounit)) <= 0) {
+			free(c);
+			break;
+		}
+		c->n = count;
+		fetch_push(f, c);
+	}
+	ixp_close(fid);
+	fetch_done(f, count == -1 ? FetchRead : FetchOk);
+}
+
+static int
+xread(int argc, char *argv[]) {
+	Fetch *fetch, *f;
+	Chunk *c, *next;
+	bool done;
+	int i;
+
 	ARGBEGIN{
 	default:
 		usage();
@@ -315,47 +539,97 @@ xread(int argc, char *argv[]) {
 
 	if(argc == 0)
 		usage();
-	file = EARGF(usage());
-	do {
-		fid = ixp_open(client, file, P9_OREAD);
-		if(fid == nil)
-			fatal("Can't open file '%s': %r\n", file);
-
-		buf = emalloc(fid->iounit);
-		while((count = ixp_read(fid, buf, fid->iounit)) > 0) {
-			unflush(1, buf, count, binary);
-			if (!binary && count < fid->iounit)
-				unflush(1, 0, 0, binary);
-		}
+
+	fetch = fetch_start(argv, argc, fetch_read);
+	for(i=0; i < argc; i++) {
+		f = &fetch[i];
+		do {
+			c = fetch_wait(f, &done);
+			for(; c; c=next) {
+				unflush(1, c->data, c->n, binary);
+				if(!binary && c->n < f->iounit)
+					unflush(1, 0, 0, binary);
+				next = c->next;
+				free(c);
+			}
+		}while(!done);
+		if(f->failed == FetchOpen)
+			fatal("Can't open file '%s': %s\n", f->file, f->error);
 		if(!binary)
 			unflush(1, 0, 0, binary);
-		ixp_close(fid);
+		if(f->failed == FetchRead)
+			lprint(2, "%s: cannot read file '%s': %s\n", argv0, f->file, f->error);
+	}
+	fetch_finish();
+	return 0;
+}
 
-		if(count == -1)
-			lprint(2, "%s: cannot read file '%s': %r\n", argv0, file);
-	} while((file = ARGF()));
+static bool	ls_dflag;
 
-	return 0;
+static void
+fetch_ls(Fetch *f) {
+	IxpMsg m;
+	IxpCFid *fid;
+	Stat *stat;
+	char *buf;
+	int count, mstat;
+
+	stat = ixp_stat(client, f->file);
+	if(stat == nil) {
+		fetch_done(f, FetchStat);
+		return;
+	}
+	f->isdir = (stat->mode&P9_DMDIR) != 0;
+	if(ls_dflag || !f->isdir) {
+		f->stat = stat;
+		f->nstat = 1;
+		fetch_done(f, FetchOk);
+		return;
+	}
+	ixp_freestat(stat);
+
+	fid = ixp_open(client, f->file, P9_OREAD);
+	if(fid == nil) {
+		fetch_done(f, FetchOpen);
+		return;
+	}
+
+	mstat = 16;
+	f->stat = emalloc(mstat * sizeof *f->stat);
+	buf = emalloc(fid->iounit);
+	while((count = ixp_read(fid, buf, fid->iounit)) > 0) {
+		m = ixp_message(buf, count, MsgUnpack);
+		while(m.pos < m.end) {
+			if(f->nstat == mstat) {
+				mstat <<= 1;
+				f->stat = erealloc(f->stat, mstat * sizeof *f->stat);
+			}
+			ixp_pstat(&m, &f->stat[f->nstat++]);
+		}
+	}
+	ixp_close(fid);
+	free(buf);
+
+	qsort(f->stat, f->nstat, sizeof *f->stat, comp_stat);
+	fetch_done(f, count == -1 ? FetchRead : FetchOk);
 }
 
 static int
 xls(int argc, char *argv[]) {
-	IxpMsg m;
-	Stat *stat;
-	IxpCFid *fid;
+	Fetch *fetch, *f;
 	char *file;
-	char *buf;
-	int lflag, dflag, pflag;
-	int count, nstat, mstat, i;
+	bool done, *slash;
+	int lflag, pflag;
+	int i, j;
 
-	lflag = dflag = pflag = 0;
+	lflag = pflag = 0;
 
 	ARGBEGIN{
 	case 'l':
 		lflag++;
 		break;
 	case 'd':
-		dflag++;
+		ls_dflag = true;
 		break;
 	case 'p':
 		pflag++;
@@ -364,56 +638,528 @@ xls(int argc, char *argv[]) {
 		usage();
 	}ARGEND;
 
-	count = 0;
-	file = EARGF(usage());
-	do {
-		stat = ixp_stat(client, file);
-		if(stat == nil)
-			fatal("cannot stat file '%s': %r\n", file);
-
-		i = strlen(file);
-		if(file[i-1] == '/') {
-			file[i-1] = '\0';
-			if(!(stat->mode&P9_DMDIR))
-				fatal("%s: not a directory", file);
+	if(argc == 0)
+		usage();
+
+	slash = emallocz(argc * sizeof *slash);
+	for(i=0; i < argc; i++) {
+		file = argv[i];
+		j = strlen(file);
+		if(j > 0 && file[j-1] == '/') {
+			file[j-1] = '\0';
+			slash[i] = true;
 		}
-		if(dflag || (stat->mode&P9_DMDIR) == 0) {
-			print_stat(stat, lflag, file, pflag);
-			ixp_freestat(stat);
-			continue;
+	}
+
+	fetch = fetch_start(argv, argc, fetch_ls);
+	for(i=0; i < argc; i++) {
+		f = &fetch[i];
+		do
+			fetch_wait(f, &done);
+		while(!done);
+		if(f->failed == FetchStat)
+			fatal("cannot stat file '%s': %s\n", f->file, f->error);
+		if(slash[i] && !f->isdir)
+			fatal("%s: not a directory", f->file);
+		if(f->failed == FetchOpen)
+			fatal("Can't open file '%s': %s\n", f->file, f->error);
+
+		for(j=0; j < f->nstat; j++) {
+			print_stat(&f->stat[j], lflag, f->file, pflag);
+			ixp_freestat(&f->stat[j]);
 		}
-		ixp_freestat(stat);
+		free(f->stat);
+
+		if(f->failed == FetchRead)
+			fatal("cannot read directory '%s': %s\n", f->file, f->error);
+	}
+	fetch_finish();
+	return 0;
+}
+
+/*
+ * Batch mode runs a stream of operations, one per line, over a
+ * single connection:
+ *
+ *	create <file> [<data>]
+ *	write <file> <data>	(or xwrite)
+ *	close <file>
+ *	remove <file>
+ *	read <file>
+ *	ls <file>
+ *
+ * Data which spans lines is given as a here-document, as in sh:
+ * "<<WORD" in place of the data, and then the lines up to one which
+ * reads WORD alone.
+ *
+ * Each is answered with a line of its own, "ok", or "error <msg>".
+ * read and ls answer "ok <n>", followed by n bytes of data, or of
+ * names, one per line. Data is converted from and to the locale's
+ * encoding, as with write and read, unless -b is given.
+ *
+ * Files written are kept open, and rewritten from the start by
+ * later writes, until they're closed or removed, a write to them
+ * fails, or the input ends. Only the HotMax most recently written
+ * are kept, so that a long-lived batch, writing to clients which come
+ * and go, doesn't gather fids without bound. Files which only take
+ * effect when closed, such as /rules, want a close after each write.
+ */
+typedef struct Hotfid Hotfid;
+struct Hotfid {
+	IxpCFid*	fid;
+	char*		file;
+	Hotfid*		next;	/* Most recently used first. */
+	Hotfid*		prev;
+};
+
+enum {
+	HotMax = 32,
+};
+
+static MapEnt*	hbucket[137];
+static Map	hotfids = { hbucket, nelem(hbucket) };
+static Hotfid	hotlist = { .next = &hotlist, .prev = &hotlist };
+
+static void
+hot_unlink(Hotfid *h) {
+	h->prev->next = h->next;
+	h->next->prev = h->prev;
+}
+
+static void
+hot_push(Hotfid *h) {
+	h->next = hotlist.next;
+	h->prev = &hotlist;
+	h->next->prev = h;
+	hotlist.next = h;
+}
+
+static void
+batch_close(char *file) {
+	Hotfid *h;
+
+	if((h = hash_rm(&hotfids, file))) {
+		hot_unlink(h);
+		ixp_close(h->fid);
+		free(h->file);
+		free(h);
+	}
+}
+
+static Hotfid*
+batch_open(char *file) {
+	IxpCFid *fid;
+	Hotfid *h;
+
+	if(hotfids.nmemb >= HotMax)
+		batch_close(hotlist.prev->file);
+	if(!(fid = ixp_open(client, file, P9_OWRITE)))
+		return nil;
+	h = emallocz(sizeof *h);
+	h->fid = fid;
+	h->file = estrdup(file);
+	*hash_get(&hotfids, file, true) = h;
+	hot_push(h);
+	return h;
+}
 
-		fid = ixp_open(client, file, P9_OREAD);
-		if(fid == nil)
-			fatal("Can't open file '%s': %r\n", file);
+/* Writes data to fid, from the locale's encoding unless -b was given. */
+static bool
+batch_send(IxpCFid *fid, char *data, int len) {
+
+	if(!flush(fid, data, len, binary))
+		return false;
+	return binary || flush(fid, nil, 0, binary);
+}
 
+static bool
+batch_write(char *file, char *data, int len) {
+	char err[IXP_ERRMAX];
+	Hotfid *h;
+	void **e;
+	bool cached, written;
+
+	for(;;) {
+		e = hash_get(&hotfids, file, false);
+		cached = e != nil;
+		if(cached) {
+			h = *e;
+			hot_unlink(h);
+			hot_push(h);
+		}else if(!(h = batch_open(file)))
+			return false;
+		h->fid->offset = 0;
+		if(batch_send(h->fid, data, len))
+			return true;
+
+		/*
+		 * Only a fid kept from an earlier write can be stale, if its
+		 * file has gone away since, and then nothing has been
+		 * written. Any other error is the server's answer to this
+		 * write, which mustn't be sent twice. Either way, the fid
+		 * is let go.
+		 */
+		written = h->fid->offset > 0;
+		utflcpy(err, ixp_errbuf(), sizeof err);
+		batch_close(file);
+		ixp_werrstr("%s", err);
+		if(!cached || written || strcmp(err, "file not found"))
+			return false;
+	}
+}
+
+static char*
+batch_read(char *file, int *np) {
+	IxpCFid *fid;
+	char *buf;
+	int n, size, count;
+
+	if(!(fid = ixp_open(client, file, P9_OREAD)))
+		return nil;
+	n = 0;
+	size = fid->iounit;
+	buf = emalloc(size);
+	while((count = ixp_read(fid, buf + n, size - n)) > 0)
+		if((n += count) == size)
+			buf = erealloc(buf, size <<= 1);
+	ixp_close(fid);
+	if(count < 0) {
+		free(buf);
+		return nil;
+	}
+	*np = n;
+	return buf;
+}
+
+static char*
+batch_ls(char *file, int *np) {
+	IxpMsg m;
+	Stat *stat;
+	Fmt f;
+	char *buf, *s;
+	int i, n, nstat;
+
+	stat = ixp_stat(client, file);
+	if(stat == nil)
+		return nil;
+	fmtstrinit(&f);
+	if((stat->mode&P9_DMDIR) == 0) {
+		fmtprint(&f, "%s\n", stat->name);
+		ixp_freestat(stat);
+	}else {
+		ixp_freestat(stat);
+		if(!(buf = batch_read(file, &n))) {
+			free(fmtstrflush(&f));
+			return nil;
+		}
+		stat = nil;
 		nstat = 0;
-		mstat = 16;
-		stat = emalloc(mstat * sizeof *stat);
-		buf = emalloc(fid->iounit);
-		while((count = ixp_read(fid, buf, fid->iounit)) > 0) {
-			m = ixp_message(buf, count, MsgUnpack);
-			while(m.pos < m.end) {
-				if(nstat == mstat) {
-					mstat <<= 1;
-					stat = erealloc(stat, mstat * sizeof *stat);
-				}
-				ixp_pstat(&m, &stat[nstat++]);
-			}
+		m = ixp_message(buf, n, MsgUnpack);
+		while(m.pos < m.end) {
+			stat = erealloc(stat, ++nstat * sizeof *stat);
+			ixp_pstat(&m, &stat[nstat-1]);
 		}
-		ixp_close(fid);
-
 		qsort(stat, nstat, sizeof *stat, comp_stat);
-		for(i = 0; i < nstat; i++) {
-			print_stat(&stat[i], lflag, file, pflag);
+		for(i=0; i < nstat; i++) {
+			fmtprint(&f, "%s%s\n", stat[i].name, stat[i].mode&P9_DMDIR ? "/" : "");
 			ixp_freestat(&stat[i]);
 		}
 		free(stat);
-	} while((file = ARGF()));
+		free(buf);
+	}
+	s = fmtstrflush(&f);
+	*np = strlen(s);
+	return s;
+}
+
+/*
+ * Converts n bytes of UTF-8 to the locale's encoding, as unflush
+ * does, but in memory, since a reply gives its length up front.
+ * Frees buf.
+ */
+static char*
+tolocale(char *buf, int *np) {
+	mbstate_t state;
+	char *out, *s, *e;
+	Rune r;
+	int n, size, res;
+
+	state = (mbstate_t){0};
+	size = *np + MB_LEN_MAX;
+	out = emalloc(size);
+	n = 0;
+	s = buf;
+	e = buf + *np;
+	while(s < e) {
+		if(size - n < MB_LEN_MAX)
+			out = erealloc(out, size <<= 1);
+		if(mbsinit(&state) && (res = asciilen(s, min(e - s, size - n)))) {
+			memcpy(out + n, s, res);
+			s += res;
+			n += res;
+			continue;
+		}
+		if(fullrune(s, e - s))
+			s += chartorune(&r, s);
+		else {
+			r = Runeerror;
+			s = e;
+		}
+		res = wcrtomb(out + n, r, &state);
+		if(res == -1)
+			out[n++] = '?';
+		else
+			n += res;
+	}
+	free(buf);
+	*np = n;
+	return out;
+}
+
+static bool
+batch_op(char *op, char *file, char *data) {
+	IxpCFid *fid;
+	char *buf;
+	int n;
+
+	buf = nil;
+	if(!strcmp(op, "write") || !strcmp(op, "xwrite")) {
+		if(!batch_write(file, data, strlen(data)))
+			return false;
+	}else if(!strcmp(op, "create")) {
+		batch_close(file);
+		if(!(fid = ixp_create(client, file, 0777, P9_OWRITE)))
+			return false;
+		n = strlen(data);
+		if(n && (fid->qid.type&P9_DMDIR) == 0 && !batch_send(fid, data, n)) {
+			ixp_close(fid);
+			return false;
+		}
+		ixp_close(fid);
+	}else if(!strcmp(op, "remove") || !strcmp(op, "rm")) {
+		batch_close(file);
+		if(!ixp_remove(client, file))
+			return false;
+	}else if(!strcmp(op, "close"))
+		batch_close(file);
+	else if(!strcmp(op, "read") || !strcmp(op, "cat")) {
+		if(!(buf = batch_read(file, &n)))
+			return false;
+	}else if(!strcmp(op, "ls")) {
+		if(!(buf = batch_ls(file, &n)))
+			return false;
+	}else {
+		ixp_werrstr("unknown operation '%s'", op);
+		return false;
+	}
+
+	if(buf) {
+		if(!binary)
+			buf = tolocale(buf, &n);
+		Bprint(outbuf, "ok %d\n", n);
+		Bwrite(outbuf, buf, n);
+		free(buf);
+	}else
+		Bprint(outbuf, "ok\n");
+	return true;
+}
+
+/*
+ * Reads the lines of a here-document, up to one which reads word
+ * alone, and returns them, each with its newline, or nil if the
+ * input ends first.
+ */
+static char*
+heredoc(Biobuf *in, char *word) {
+	Fmt f;
+	char *s;
+
+	fmtstrinit(&f);
+	while((s = Brdstr(in, '\n', true))) {
+		if(!strcmp(s, word)) {
+			free(s);
+			return fmtstrflush(&f);
+		}
+		fmtprint(&f, "%s\n", s);
+		free(s);
+	}
+	free(fmtstrflush(&f));
+	return nil;
+}
+
+static int
+xbatch(int argc, char *argv[]) {
+	Biobuf *in;
+	char *file, *line, *op, *data, *doc, *word;
+
+	ARGBEGIN{
+	default:
+		usage();
+	}ARGEND;
+
+	if((file = ARGF())) {
+		if(!(in = Bopen(file, OREAD)))
+			fatal("Can't open %q: %r\n", file);
+	}else
+		in = Bfdopen(0, OREAD);
+
+	while((line = Brdstr(in, '\n', true))) {
+		/* <op> <file> [<data> | <<WORD] */
+		op = line;
+		file = strchr(op, ' ');
+		data = "";
+		if(file) {
+			*file++ = '\0';
+			if((data = strchr(file, ' ')))
+				*data++ = '\0';
+			else
+				data = "";
+		}
+		doc = nil;
+		if(!strncmp(data, "<<", 2) && data[2]) {
+			word = data + 2;
+			if(!(doc = heredoc(in, word))) {
+				Bprint(outbuf, "error %s %s: no line %q ends the data\n", op, file, word);
+				free(line);
+				break;
+			}
+			data = doc;
+		}
+		if(*op && (file == nil || !*file))
+			Bprint(outbuf, "error %s: no file given\n", op);
+		else if(*op && !batch_op(op, file, data))
+			Bprint(outbuf, "error %s %s: %r\n", op, file);
+		Bflush(outbuf);
+		free(doc);
+		free(line);
+	}
+
+	while(hotlist.next != &hotlist)
+		batch_close(hotlist.next->file);
+	Bterm(in);
+	return 0;
+}
+
+/*
+ * Prints each event which matches one of the given patterns, as
+ * wi_events' case statements would match it, as a line of shell:
+ *
+ *	wi_arg='<all but the first word>'; set -- '<word>' ...
+ *
+ * so that wi_eventloop can run its handlers without forking to split
+ * each event itself, or running them for events nobody handles.
+ * Start events always pass, so the loop can tell when to exit.
+ */
+static char*	evbuf;
+static int	evlen;
+static int	evsize;
+
+static void
+evput(char *s, int n) {
+
+	if(evlen + n + 1 > evsize) {
+		evsize = max(evsize * 2, evlen + n + 1);
+		evbuf = erealloc(evbuf, evsize);
+	}
+	memcpy(evbuf + evlen, s, n);
+	evlen += n;
+	evbuf[evlen] = '\0';
+}
+
+static void
+evquote(char *s, int n) {
+	char *q;
+
+	evput("'", 1);
+	while((q = memchr(s, '\'', n))) {
+		evput(s, q - s);
+		evput("'\\''", 4);
+		n -= q + 1 - s;
+		s = q + 1;
+	}
+	evput(s, n);
+	evput("'", 1);
+}
+
+static void
+event(char *line, char *pattern[], int npattern) {
+	char *p, *arg;
+	int i, n;
+
+	n = strcspn(line, " \t");
+	if(n == 0)
+		return;
+	if(n != 5 || strncmp(line, "Start", 5)) {
+		p = estrndup(line, n);
+		for(i=0; i < npattern; i++)
+			if(!fnmatch(pattern[i], p, 0))
+				break;
+		free(p);
+		if(i == npattern)
+			return;
+	}
+
+	arg = strchr(line, ' ');
+	arg = arg ? arg + 1 : line;
+	evlen = 0;
+	evput("wi_arg=", 7);
+	evquote(arg, strlen(arg));
+	evput("; set --", 8);
+	for(p=line; *p;) {
+		n = strcspn(p, " \t");
+		if(n > 0) {
+			evput(" ", 1);
+			evquote(p, n);
+		}
+		p += n;
+		p += strspn(p, " \t");
+	}
+	Blprint(outbuf, "%s\n", evbuf);
+	Bflush(outbuf);
+}
+
+static int
+xevents(int argc, char *argv[]) {
+	IxpCFid *fid;
+	char *buf, *p, *q;
+	bool fromstdin;
+	int n, len, size;
+
+	fromstdin = false;
+	ARGBEGIN{
+	case 'i':
+		fromstdin = true;
+		break;
+	default:
+		usage();
+	}ARGEND;
 
-	if(count == -1)
-		fatal("cannot read directory '%s': %r\n", file);
+	fid = nil;
+	if(!fromstdin && !(fid = ixp_open(client, "/event", P9_OREAD)))
+		fatal("Can't open file '/event': %r\n");
+
+	size = IXP_MAX_MSG;
+	buf = emalloc(size);
+	len = 0;
+	for(;;) {
+		if(len == size)
+			buf = erealloc(buf, size <<= 1);
+		if(fid)
+			n = ixp_read(fid, buf + len, min(size - len, fid->iounit));
+		else
+			n = read(0, buf + len, size - len);
+		if(n <= 0)
+			break;
+		len += n;
+		for(p=buf; (q = memchr(p, '\n', buf + len - p)); p=q+1) {
+			*q = '\0';
+			event(p, argv, argc);
+		}
+		len -= p - buf;
+		memmove(buf, p, len);
+	}
+	if(fid)
+		ixp_close(fid);
 	return 0;
 }
 
@@ -433,38 +1179,306 @@ xnamespace(int argc, char *argv[]) {
 	return 0;
 }
 
-static int
-xproglist(int argc, char *argv[]) {
+/*
+ * With -c, the programs in each directory are cached in the
+ * namespace directory, keyed by the directory's device, inode, and
+ * modification time, so that only those directories which have
+ * changed since the last run need be read.
+ */
+#define PROGCACHE "proglist cache 1"
+
+typedef struct Progdir Progdir;
+struct Progdir {
+	char*		key;
+	time_t		mtime;
+	Vector_ptr	names;
+};
+
+static MapEnt*		pbucket[137];
+static Map		progmap = { pbucket, nelem(pbucket) };
+static Vector_ptr	progdirs;
+static bool		progdirty;
+
+static Progdir*
+progdir_get(char *key) {
+	Progdir **pp;
+
+	pp = (Progdir**)hash_get(&progmap, key, true);
+	if(*pp == nil) {
+		*pp = emallocz(sizeof **pp);
+		(*pp)->key = estrdup(key);
+		vector_ppush(&progdirs, *pp);
+	}
+	return *pp;
+}
+
+static void
+progdir_clear(Progdir *p) {
+	int i;
+
+	for(i=0; i < p->names.n; i++)
+		free(p->names.ary[i]);
+	p->names.n = 0;
+}
+
+/*
+ * Reads the executables in dir into names. Returns false if the
+ * list can't be cached, because the directory couldn't be read,
+ * or because a name won't fit on a line of the cache. Entries are
+ * looked up relative to the directory's fd, rather than by way of
+ * chdir, so that several directories may be read at once.
+ */
+static bool
+progscan(char *dir, Vector_ptr *names) {
 	DIR *d;
 	struct dirent *de;
 	struct stat st;
-	char *dir, *cwd;
-	int i;
+	bool ok;
+	int fd;
+
+	fd = open(dir, O_RDONLY|O_DIRECTORY);
+	if(fd < 0)
+		return false;
+	if(!(d = fdopendir(fd))) {
+		close(fd);
+		return false;
+	}
+	ok = true;
+	while((de = readdir(d))) {
+#ifdef DT_UNKNOWN
+		/* Only links, and file systems which don't say, need a stat. */
+		if(de->d_type != DT_REG && de->d_type != DT_LNK && de->d_type != DT_UNKNOWN)
+			continue;
+		if(de->d_type != DT_REG)
+#endif
+		if(fstatat(fd, de->d_name, &st, 0) || !S_ISREG(st.st_mode))
+			continue;
+		if(faccessat(fd, de->d_name, X_OK, 0))
+			continue;
+		if(strchr(de->d_name, '\n'))
+			ok = false;
+		vector_ppush(names, estrdup(de->d_name));
+	}
+	closedir(d);
+	return ok;
+}
+
+/*
+ * Directories are read by a small pool of threads, so that a slow
+ * one, on a network file system, needn't hold up the rest. Each
+ * fills its own list, and the lists are printed in argument order
+ * once they're all done.
+ */
+enum {
+	ProgThreads = 8,
+};
+
+typedef struct Progscan Progscan;
+struct Progscan {
+	char*		dir;
+	Vector_ptr*	names;
+	Progdir*	prog;
+	bool		ok;
+};
+
+static struct {
+	pthread_mutex_t	lock;
+	Progscan*	scan;
+	int		n;
+	int		next;
+} progpool = { PTHREAD_MUTEX_INITIALIZER };
+
+static void*
+progworker(void *arg) {
+	Progscan *s;
+
+	USED(arg);
+	for(;;) {
+		pthread_mutex_lock(&progpool.lock);
+		s = nil;
+		if(progpool.next < progpool.n)
+			s = &progpool.scan[progpool.next++];
+		pthread_mutex_unlock(&progpool.lock);
+		if(s == nil)
+			return nil;
+		s->ok = progscan(s->dir, s->names);
+	}
+}
+
+static void
+progscan_all(Progscan *scan, int n) {
+	pthread_t thread[ProgThreads - 1];
+	int i, nthread;
+
+	progpool.scan = scan;
+	progpool.n = n;
+	progpool.next = 0;
+
+	/* The calling thread is the last worker. */
+	for(nthread=0; nthread < min(n, ProgThreads) - 1; nthread++)
+		if(pthread_create(&thread[nthread], nil, progworker, nil))
+			break;
+	progworker(nil);
+	for(i=0; i < nthread; i++)
+		pthread_join(thread[i], nil);
+}
+
+static void
+progcache_load(char *path) {
+	Biobuf *b;
+	Progdir *p;
+	char *s, *key, *name;
+	long n;
+	time_t mtime;
+
+	b = Bopen(path, OREAD);
+	if(b == nil)
+		return;
+	s = Brdstr(b, '\n', true);
+	if(s == nil || strcmp(s, PROGCACHE))
+		goto done;
+	free(s);
+	while((s = Brdstr(b, '\n', true))) {
+		/* <count> <mtime> <device>.<inode> */
+		n = strtol(s, &key, 10);
+		mtime = strtoll(key, &key, 10);
+		if(*key++ != ' ')
+			break;
+		p = progdir_get(key);
+		progdir_clear(p);
+		for(; n > 0; n--) {
+			if(!(name = Brdstr(b, '\n', true)))
+				break;
+			vector_ppush(&p->names, name);
+		}
+		p->mtime = n ? 0 : mtime;
+		free(s);
+	}
+done:
+	free(s);
+	Bterm(b);
+}
+
+static void
+progcache_dump(char *path) {
+	Biobuf b;
+	Progdir *p;
+	char *tmp;
+	int i, j, fd;
+
+	tmp = smprint("%s.XXXXXX", path);
+	fd = mkstemp(tmp);
+	if(fd < 0) {
+		free(tmp);
+		return;
+	}
+	Binit(&b, fd, OWRITE);
+	Bprint(&b, "%s\n", PROGCACHE);
+	for(i=0; i < progdirs.n; i++) {
+		p = progdirs.ary[i];
+		if(p->mtime == 0)
+			continue;
+		Bprint(&b, "%ld %lld %s\n", p->names.n, (vlong)p->mtime, p->key);
+		for(j=0; j < p->names.n; j++)
+			Bprint(&b, "%s\n", p->names.ary[j]);
+	}
+	if(Bflush(&b) == 0)
+		rename(tmp, path);
+	else
+		unlink(tmp);
+	Bterm(&b);
+	close(fd);
+	free(tmp);
+}
+
+/*
+ * Returns the cached program list for dir, and sets *stale if it
+ * needs to be read again, because the directory has changed.
+ */
+static Progdir*
+progdir(char *dir, bool *stale) {
+	struct stat st;
+	Progdir *p;
+
+	*stale = false;
+	if(stat(dir, &st))
+		return nil;
+	p = progdir_get(sxprint("%ullx.%ullx", (uvlong)st.st_dev, (uvlong)st.st_ino));
+	if(p->mtime && p->mtime == st.st_mtime)
+		return p;
+
+	*stale = true;
+	progdirty = true;
+	progdir_clear(p);
+	p->mtime = st.st_mtime;
+	return p;
+}
+
+static int
+xproglist(int argc, char *argv[]) {
+	Vector_ptr **lists;
+	Progscan *scan;
+	Progdir *p;
+	char *ns, *cache;
+	bool docache, stale;
+	time_t now;
+	int i, j, n;
 
 	quotefmtinstall();
 
+	docache = false;
 	ARGBEGIN{
+	case 'c':
+		docache = true;
+		break;
 	default:
 		usage();
 	}ARGEND;
 
-	i = 7, cwd = nil;
-	do
-		cwd = erealloc(cwd, 1<<i);
-	while(!getcwd(cwd, 1<<i) && errno == ERANGE);
-
-	while((dir = ARGF()))
-		/* Don't use Blprint. wimenu expects UTF-8. */
-		if(!chdir(cwd) && !chdir(dir) && (d = opendir(dir))) {
-			while((de = readdir(d))) {
-				stat(de->d_name, &st);
-				if(S_ISREG(st.st_mode) && !access(de->d_name, X_OK))
-					Bprint(outbuf, "%q\n", de->d_name);
-			}
-			closedir(d);
-		}
+	cache = nil;
+	if(docache && (ns = ixp_namespace())) {
+		cache = estrdup(sxprint("%s/.proglist.cache", ns));
+		progcache_load(cache);
+	}
+
+	now = time(nil);
+	lists = emallocz(argc * sizeof *lists);
+	scan = emallocz(argc * sizeof *scan);
+	n = 0;
+	for(i=0; i < argc; i++) {
+		if(cache) {
+			if(!(p = progdir(argv[i], &stale)))
+				continue;
+			lists[i] = &p->names;
+			if(!stale)
+				continue;
+			scan[n].prog = p;
+		}else
+			lists[i] = emallocz(sizeof *lists[i]);
+		scan[n].dir = argv[i];
+		scan[n].names = lists[i];
+		n++;
+	}
+
+	progscan_all(scan, n);
 
-	return 0; /* NOTREACHED */
+	/*
+	 * A directory modified within the last second may change again
+	 * without its mtime doing so, so its list isn't trusted next time.
+	 */
+	for(i=0; i < n; i++)
+		if(scan[i].prog && (!scan[i].ok || scan[i].prog->mtime >= now - 1))
+			scan[i].prog->mtime = 0;
+
+	/* Don't use Blprint. wimenu expects UTF-8. */
+	for(i=0; i < argc; i++)
+		if(lists[i])
+			for(j=0; j < lists[i]->n; j++)
+				Bprint(outbuf, "%q\n", lists[i]->ary[j]);
+
+	if(cache && progdirty)
+		progcache_dump(cache);
+	return 0;
 }
 
 static int
@@ -508,7 +1522,9 @@ struct exectab {
 	int (*fn)(int, char**);
 } fstab[] = {
 	{"cat", xread},
+	{"batch", xbatch},
 	{"create", xcreate},
+	{"events", xevents},
 	{"ls", xls},
 	{"read", xread},
 	{"remove", xremove},
@@ -531,6 +1547,7 @@ main(int argc, char *argv[]) {
 	int ret;
 
 	IXP_ASSERT_VERSION;
+	ixp_pthread_init();
 
 	setlocale(LC_ALL, "");
 	binary = utf8locale();
@@ -32,6 +32,7 @@ PYTHON = python
 X11PACKAGES = x11 xinerama xrender xrandr
 INCX11 = $$(pkg-config --cflags $(X11PACKAGES))
 LIBIXP = $(LIBDIR)/libixp.a
+LIBIXP_PTHREAD = $(LIBDIR)/libixp_pthread.a
 
 # Enable RTLD. Only necessary for Xft support.
 CFLAGS += -DHAVE_RTLD
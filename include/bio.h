@@ -41,6 +41,7 @@ struct	Biobuf
 	unsigned char*	bbuf;		/* pointer to beginning of buffer */
 	unsigned char*	ebuf;		/* pointer to end of buffer */
 	unsigned char*	gbuf;		/* pointer to good data in buf */
+	unsigned char*	xbuf;		/* grown buffer, if malloc'ed */
 	unsigned char	b[Bungetsize+Bsize];
 };
 
@@ -75,6 +76,8 @@ int	Bprint(Biobuf*, const char*, ...);
 int	Bputc(Biobuf*, int);
 int	Bputrune(Biobuf*, long);
 void*	Brdline(Biobuf*, int);
+void*	Brdlines(Biobuf*, int, int*);
+void*	Brdslice(Biobuf*, int, int*);
 char*	Brdstr(Biobuf*, int, int);
 long	Bread(Biobuf*, void*, long);
 off_t	Bseek(Biobuf*, off_t, int);
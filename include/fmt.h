@@ -130,6 +130,7 @@ extern	int	(*fmtdoquote)(int);
 /* Edit .+1,/^$/ | cfn $PLAN9/src/lib9/fmt/?*.c | grep -v static |grep -v __ */
 int		dofmt(Fmt*, const char *fmt);
 int		dorfmt(Fmt*, const Rune *fmt);
+int		fmtbufinit(Fmt*, char *buf, int size);
 double		fmtcharstod(int(*f)(void*), void*);
 int		fmtfdflush(Fmt*);
 int		fmtfdinit(Fmt*, int fd, char *buf, int size);
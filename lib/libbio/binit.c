@@ -85,6 +85,7 @@ Binits(Biobuf *bp, int f, int mode, unsigned char *p, int size)
 	bp->gbuf = bp->ebuf;
 	bp->fid = f;
 	bp->flag = 0;
+	bp->xbuf = 0;
 	bp->rdline = 0;
 	bp->offset = 0;
 	bp->runesize = 0;
@@ -145,6 +146,8 @@ Bterm(Biobuf *bp)
 
 	deinstall(bp);
 	Bflush(bp);
+	free(bp->xbuf);
+	bp->xbuf = 0;
 	if(bp->flag == Bmagic) {
 		bp->flag = 0;
 		close(bp->fid);
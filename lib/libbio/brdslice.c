@@ -0,0 +1,139 @@
+#include	<stdlib.h>
+#include	"plan9.h"
+#include	<bio.h>
+
+/*
+ * Double the buffer, whose bsize bytes of data have been moved to
+ * its start. The old buffer is freed if it was one of ours.
+ */
+static int
+bgrow(Biobuf *bp)
+{
+	unsigned char *p;
+	int n;
+
+	n = bp->bsize * 2;
+	p = malloc(Bungetsize + n);
+	if(p == 0)
+		return Beof;
+	memmove(p, bp->bbuf-Bungetsize, Bungetsize + bp->bsize);
+	free(bp->xbuf);
+	bp->xbuf = p;
+	bp->bbuf = p + Bungetsize;
+	bp->ebuf = bp->bbuf + n;
+	bp->gbuf = bp->bbuf;
+	bp->bsize = n;
+	return 0;
+}
+
+/*
+ * Like Brdline, but the buffer grows to fit long lines, and a
+ * last line with no delimiter is returned as it is. The line is
+ * left in the buffer, and its length, including the delimiter if
+ * there is one, in *np.
+ */
+void*
+Brdslice(Biobuf *bp, int delim, int *np)
+{
+	char *ip, *ep;
+	int i, j;
+
+	*np = 0;
+	i = -bp->icount;
+	if(i == 0) {
+		/*
+		 * eof or other error
+		 */
+		if(bp->state != Bractive) {
+			if(bp->state == Bracteof)
+				bp->state = Bractive;
+			bp->rdline = 0;
+			bp->gbuf = bp->ebuf;
+			return 0;
+		}
+	}
+
+	/*
+	 * first try in remainder of buffer (gbuf doesn't change)
+	 */
+	ip = (char*)bp->ebuf - i;
+	ep = memchr(ip, delim, i);
+	if(ep) {
+		j = (ep - ip) + 1;
+		bp->rdline = j;
+		bp->icount += j;
+		*np = j;
+		return ip;
+	}
+
+	/*
+	 * copy data to beginning of buffer
+	 */
+	if(i < bp->bsize)
+		memmove(bp->bbuf, ip, i);
+	bp->gbuf = bp->bbuf;
+
+	/*
+	 * append to buffer looking for the delim, growing it when full
+	 */
+	for(;;) {
+		if(i == bp->bsize && bgrow(bp) < 0) {
+			bp->rdline = i;
+			bp->icount = -i;
+			return 0;
+		}
+		ip = (char*)bp->bbuf + i;
+		j = read(bp->fid, ip, bp->bsize-i);
+		if(j <= 0) {
+			/*
+			 * end of file: what's left is the last line
+			 */
+			j = i;
+			break;
+		}
+		bp->offset += j;
+		i += j;
+		ep = memchr(ip, delim, j);
+		if(ep) {
+			j = (ep - (char*)bp->bbuf) + 1;
+			break;
+		}
+	}
+
+	/*
+	 * copy back up and reset everything
+	 */
+	ip = (char*)bp->ebuf - i;
+	if(i < bp->bsize){
+		memmove(ip, bp->bbuf, i);
+		bp->gbuf = (unsigned char*)ip;
+	}
+	bp->rdline = j;
+	bp->icount = j - i;
+	*np = j;
+	if(j == 0)
+		return 0;
+	return ip;
+}
+
+/*
+ * Like Brdslice, but returns as many whole lines as the buffer
+ * holds, at least one, for the caller to split.
+ */
+void*
+Brdlines(Biobuf *bp, int delim, int *np)
+{
+	char *ip, *ep, *p;
+
+	ip = Brdslice(bp, delim, np);
+	if(ip == 0)
+		return 0;
+	ep = ip + *np;
+	for(p=(char*)bp->ebuf; p > ep; p--)
+		if(p[-1] == delim)
+			break;
+	bp->icount += p - ep;
+	bp->rdline += p - ep;
+	*np += p - ep;
+	return ip;
+}
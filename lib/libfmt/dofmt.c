@@ -234,9 +234,17 @@ __fmtrcpy(Fmt *f, const void *vm, int n)
 int
 __charfmt(Fmt *f)
 {
-	char x[1];
+	char x[1], *t, *s;
 
 	x[0] = va_arg(f->args, int);
+	if(!f->runes && !(f->flags & FmtWidth) && (uchar)x[0] < Runeself){
+		t = (char*)f->to;
+		s = (char*)f->stop;
+		FMTCHAR(f, t, s, x[0]);
+		f->nfmt += t - (char *)f->to;
+		f->to = t;
+		return 0;
+	}
 	f->prec = 1;
 	return __fmtcpy(f, (const char*)x, 1, 1);
 }
@@ -270,6 +278,29 @@ fmtstrcpy(Fmt *f, const char *s)
 	return __fmtcpy(f, s, utflen(s), strlen(s));
 }
 
+/*
+ * fmt out a null terminated utf string with no width or precision:
+ * its leading ASCII is copied as is, and only the rest is decoded.
+ */
+static int
+strfast(Fmt *f, const char *m)
+{
+	char *t, *s;
+	int c;
+
+	t = (char*)f->to;
+	s = (char*)f->stop;
+	while((c = *(uchar*)m) != 0 && c < Runeself){
+		FMTCHAR(f, t, s, c);
+		m++;
+	}
+	f->nfmt += t - (char *)f->to;
+	f->to = t;
+	if(c == 0)
+		return 0;
+	return __fmtcpy(f, m, utflen(m), strlen(m));
+}
+
 /* fmt out a null terminated utf string */
 int
 __strfmt(Fmt *f)
@@ -277,6 +308,8 @@ __strfmt(Fmt *f)
 	char *s;
 
 	s = va_arg(f->args, char *);
+	if(s && !f->runes && !(f->flags & (FmtWidth|FmtPrec)))
+		return strfast(f, s);
 	return fmtstrcpy(f, s);
 }
 
@@ -324,6 +357,93 @@ __percentfmt(Fmt *f)
 	return __fmtrcpy(f, (const void*)x, 1);
 }
 
+static char digitpairs[] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+/*
+ * fmt an integer with no width, precision or separators: %d, %ud,
+ * %x, %#x and the like. Decimal is converted two digits at a time.
+ */
+static int
+ifmtfast(Fmt *f)
+{
+	char buf[32], *p, *t, *s, *conv;
+	uvlong v;
+	ulong fl;
+	int i, n, neg;
+
+	fl = f->flags;
+	if(fl & FmtVLong){
+		if(fl & FmtUnsigned)
+			v = va_arg(f->args, uvlong);
+		else
+			v = va_arg(f->args, vlong);
+	}else if(fl & FmtLong){
+		if(fl & FmtUnsigned)
+			v = va_arg(f->args, ulong);
+		else
+			v = va_arg(f->args, long);
+	}else{
+		if(fl & FmtUnsigned)
+			v = va_arg(f->args, uint);
+		else
+			v = va_arg(f->args, int);
+	}
+	neg = 0;
+	if(!(fl & FmtUnsigned) && (vlong)v < 0){
+		v = -v;
+		neg = 1;
+	}
+
+	p = buf + sizeof buf;
+	if(f->r == 'd'){
+		while(v >= 100){
+			i = (v % 100) * 2;
+			v /= 100;
+			*--p = digitpairs[i+1];
+			*--p = digitpairs[i];
+		}
+		if(v >= 10){
+			*--p = digitpairs[v*2+1];
+			*--p = digitpairs[v*2];
+		}else
+			*--p = '0' + v;
+	}else{
+		conv = f->r == 'X' ? "0123456789ABCDEF" : "0123456789abcdef";
+		/* Zero values don't get 0x. */
+		if(v == 0)
+			fl &= ~FmtSharp;
+		do
+			*--p = conv[v & 0xf];
+		while((v >>= 4) != 0);
+		if(fl & FmtSharp){
+			*--p = f->r;
+			*--p = '0';
+		}
+	}
+	if(neg)
+		*--p = '-';
+
+	n = buf + sizeof buf - p;
+	t = (char*)f->to;
+	s = (char*)f->stop;
+	if(t + n > s)
+		return __fmtcpy(f, p, n, n);
+	memcpy(t, p, n);
+	f->nfmt += n;
+	f->to = t + n;
+	return 0;
+}
+
 /* fmt an integer */
 int
 __ifmt(Fmt *f)
@@ -337,6 +457,10 @@ __ifmt(Fmt *f)
 	char *grouping;
 	char *thousands;
 
+	if(!f->runes && (f->r == 'd' || f->r == 'x' || f->r == 'X')
+	&& !(f->flags & ~(FmtUnsigned|FmtSharp|FmtLong|FmtVLong)))
+		return ifmtfast(f);
+
 	neg = 0;
 	fl = f->flags;
 	isv = 0;
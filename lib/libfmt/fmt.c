@@ -36,6 +36,12 @@ struct
 	Convfmt	fmt[Maxfmt];
 } fmtalloc;
 
+/*
+ * the handlers of ASCII verbs, once looked up, so that the common
+ * verbs needn't search fmtalloc. set under __fmtlock.
+ */
+static volatile Fmts fmtcache[Runeself];
+
 static Convfmt knownfmt[] = {
 	' ',	__flagfmt,
 	'#',	__flagfmt,
@@ -96,6 +102,8 @@ __fmtinstall(int c, Fmts f)
 		fmtalloc.nfmt++;
 		p->c = c;
 	}
+	if(c < Runeself)
+		fmtcache[c] = f;
 
 	return 0;
 }
@@ -115,6 +123,10 @@ static Fmts
 fmtfmt(int c)
 {
 	Convfmt *p, *ep;
+	Fmts f;
+
+	if(c < Runeself && (f = fmtcache[c]) != nil)
+		return f;
 
 	ep = &fmtalloc.fmt[fmtalloc.nfmt];
 	for(p=fmtalloc.fmt; p<ep; p++)
@@ -47,6 +47,55 @@ fmtStrFlush(Fmt *f)
 	return 1;
 }
 
+/*
+ * the caller's buffer is full: move to the heap, and grow from there
+ * as with fmtstrinit.
+ */
+static int
+fmtBufFlush(Fmt *f)
+{
+	char *s;
+	int n;
+
+	n = (uintptr_t)f->farg;
+	n *= 2;
+	s = malloc(n);
+	if(s == nil){
+		f->start = nil;
+		f->farg = nil;
+		f->to = nil;
+		f->stop = nil;
+		return 0;
+	}
+	memmove(s, f->start, (char*)f->to - (char*)f->start);
+	f->farg = (void*)(uintptr_t)n;
+	f->to = s + ((char*)f->to - (char*)f->start);
+	f->start = s;
+	f->stop = s + n - 1;
+	f->flush = fmtStrFlush;
+	return 1;
+}
+
+/*
+ * like fmtstrinit, but starts out in the caller's buffer, buf, and
+ * allocates only if the output won't fit there. the string returned
+ * by fmtstrflush is to be freed only if it isn't buf.
+ */
+int
+fmtbufinit(Fmt *f, char *buf, int size)
+{
+	memset(f, 0, sizeof *f);
+	f->runes = 0;
+	f->start = buf;
+	f->to = buf;
+	f->stop = buf + size - 1;
+	f->flush = fmtBufFlush;
+	f->farg = (void*)(uintptr_t)size;
+	f->nfmt = 0;
+	fmtlocaleinit(f, nil, nil, nil);
+	return 0;
+}
+
 int
 fmtstrinit(Fmt *f)
 {
@@ -0,0 +1,172 @@
+/*
+ * Generates runetab.h from the tables of runetypedata.h. This is
+ * only run by hand, through "make runetab", and the output is kept
+ * in the tree.
+ *
+ * Every rune is given a class: its properties and its case deltas.
+ * The space is cut into blocks of RuneBlock runes, which become rows
+ * of class indices, and identical rows are shared. Runes past the
+ * last row which isn't all class 0 are left out of the table.
+ *
+ * The result is checked against the binary search over the original
+ * tables, for every rune, before anything is printed.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "plan9.h"
+#include "utf.h"
+#include "utfdef.h"
+#include "runetypedata.h"
+
+enum {
+	Nblock	= (Runemax+1) / RuneBlock,
+	Nclass	= 256,
+};
+
+static Runeclass	class[Nclass];
+static int		nclass;
+static uchar		block[Nblock][RuneBlock];
+static int		nblock;
+static int		stage1[Nblock];
+static int		nstage1;
+
+static void
+fail(char *msg, Rune c) {
+	fprintf(stderr, "mkrunetab: %s: U+%04X\n", msg, c);
+	exit(1);
+}
+
+static Runeclass
+classify(Rune c) {
+	Runeclass r;
+
+	r.props = 0;
+	if(__islowerrune(c))
+		r.props |= Plower;
+	if(__isupperrune(c))
+		r.props |= Pupper;
+	if(__isalpharune(c))
+		r.props |= Palpha;
+	if(__isspacerune(c))
+		r.props |= Pspace;
+	r.upper = (int)(__toupperrune(c) - c);
+	r.lower = (int)(__tolowerrune(c) - c);
+	r.title = (int)(__totitlerune(c) - c);
+	return r;
+}
+
+static int
+getclass(Rune c) {
+	Runeclass r;
+	int i;
+
+	r = classify(c);
+	for(i=0; i < nclass; i++)
+		if(class[i].props == r.props && class[i].upper == r.upper
+		&& class[i].lower == r.lower && class[i].title == r.title)
+			return i;
+	if(nclass == Nclass)
+		fail("too many rune classes", c);
+	class[nclass] = r;
+	return nclass++;
+}
+
+static void
+build(void) {
+	uchar row[RuneBlock];
+	Runeclass r;
+	Rune c;
+	int i, j, last;
+
+	/* Class 0 is that of the runes with no properties. */
+	memset(&r, 0, sizeof r);
+	class[nclass++] = r;
+
+	last = 0;
+	for(i=0; i < Nblock; i++) {
+		for(j=0; j < RuneBlock; j++) {
+			c = i*RuneBlock + j;
+			row[j] = getclass(c);
+			if(row[j] != 0)
+				last = i;
+		}
+		for(j=0; j < nblock; j++)
+			if(!memcmp(block[j], row, sizeof row))
+				break;
+		if(j == nblock)
+			memcpy(block[nblock++], row, sizeof row);
+		stage1[i] = j;
+	}
+	nstage1 = last + 1;
+}
+
+static void
+check(void) {
+	Runeclass *p, r;
+	Rune c;
+
+	for(c=0; c <= Runemax; c++) {
+		if(c>>RuneBlockBits < nstage1)
+			p = &class[block[stage1[c>>RuneBlockBits]][c&(RuneBlock-1)]];
+		else
+			p = &class[0];
+		r = classify(c);
+		if(p->props != r.props || p->upper != r.upper
+		|| p->lower != r.lower || p->title != r.title)
+			fail("class mismatch", c);
+		if(c + p->upper != __toupperrune(c)
+		|| c + p->lower != __tolowerrune(c)
+		|| c + p->title != __totitlerune(c)
+		|| !!(p->props & Plower) != __islowerrune(c)
+		|| !!(p->props & Pupper) != __isupperrune(c)
+		|| !!(p->props & Palpha) != __isalpharune(c)
+		|| !!(p->props & Pspace) != __isspacerune(c)
+		|| ((p->props & (Plower|Pupper)) == (Plower|Pupper)) != __istitlerune(c))
+			fail("lookup mismatch", c);
+	}
+}
+
+static void
+dump(void) {
+	int i, j;
+
+	printf("/* Generated by mkrunetab from runetypedata.h. Do not edit. */\n\n");
+	printf("enum {\n");
+	printf("\tRuneLimit\t= 0x%x,\n", nstage1 * RuneBlock);
+	printf("\tRuneAscii\t= %d,\n", stage1[0]);
+	printf("};\n\n");
+
+	printf("static %s\t__runeindex[%d] = {",
+	       nblock <= 256 ? "uchar" : "ushort", nstage1);
+	for(i=0; i < nstage1; i++)
+		printf("%s%d,", i % 16 ? " " : "\n\t", stage1[i]);
+	printf("\n};\n\n");
+
+	printf("static uchar\t__runeblock[%d][RuneBlock] = {\n", nblock);
+	for(i=0; i < nblock; i++) {
+		printf("\t{");
+		for(j=0; j < RuneBlock; j++)
+			printf("%s%d,", j % 16 ? " " : "\n\t\t", block[i][j]);
+		printf("\n\t},\n");
+	}
+	printf("};\n\n");
+
+	printf("static Runeclass\t__runeclass[%d] = {\n", nclass);
+	for(i=0; i < nclass; i++)
+		printf("\t{0x%x, %d, %d, %d},\n",
+		       class[i].props, class[i].upper, class[i].lower, class[i].title);
+	printf("};\n");
+}
+
+int
+main(void) {
+
+	build();
+	check();
+	dump();
+	if(fflush(stdout) || ferror(stdout)) {
+		perror("mkrunetab");
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,118 @@
+#include <stdarg.h>
+#include <string.h>
+#include "plan9.h"
+#include "utf.h"
+#include "utfdef.h"
+
+#ifdef __SSE2__
+# include <emmintrin.h>
+#endif
+
+/*
+ * Runs of ASCII, which is most of what wmii handles, are skipped a
+ * block at a time: 16 bytes with SSE2, or a word otherwise. A block
+ * never straddles a page boundary, so that reading one never strays
+ * into a page which the string itself doesn't reach. With SSE2,
+ * blocks are only aligned near the end of a page, so that short runs
+ * between multi-byte runes cost a single load.
+ */
+
+typedef uintptr_t Word;
+
+enum
+{
+	Block	= 16,
+	Page	= 4096,
+};
+
+#define	ONES	((Word)-1 / 0xFF)
+#define	HIGHS	(ONES * 0x80)
+
+/* Whether w has a zero byte, or one with its high bit set. */
+#define	notascii(w)	((((w) - ONES) & ~(w) | (w)) & HIGHS)
+
+static int
+isascii1(const char *p)
+{
+	int c;
+
+	c = *(uchar*)p;
+	return c != 0 && c < Runeself;
+}
+
+/*
+ * Returns the length of the run of ASCII bytes (those from 1 to
+ * Runeself-1) at the start of s, which is 0 if s doesn't begin with
+ * one. The byte after the run is either NUL or begins a multi-byte
+ * sequence.
+ */
+long
+__utfascii(const char *s)
+{
+	const char *p;
+#ifdef __SSE2__
+	__m128i v, zero;
+	int m;
+
+	zero = _mm_setzero_si128();
+	for(p = s;; p += Block) {
+		if((uintptr_t)p % Page > Page - Block)
+			for(; (uintptr_t)p % Block; p++)
+				if(!isascii1(p))
+					return p - s;
+		v = _mm_loadu_si128((const __m128i*)p);
+		m = _mm_movemask_epi8(_mm_or_si128(v, _mm_cmpeq_epi8(v, zero)));
+		if(m)
+			return p - s + __builtin_ctz(m);
+	}
+#else
+	Word w;
+
+	for(p = s; (uintptr_t)p % sizeof w; p++)
+		if(!isascii1(p))
+			return p - s;
+	for(;; p += sizeof w) {
+		memcpy(&w, p, sizeof w);
+		if(notascii(w))
+			break;
+	}
+	while(isascii1(p))
+		p++;
+	return p - s;
+#endif
+}
+
+/* As __utfascii, but looks at no more than n bytes. */
+long
+__utfnascii(const char *s, long n)
+{
+	const char *p, *e;
+#ifdef __SSE2__
+	__m128i v, zero;
+	int m;
+
+	e = s + n;
+	zero = _mm_setzero_si128();
+	for(p = s; e - p >= Block; p += Block) {
+		v = _mm_loadu_si128((const __m128i*)p);
+		m = _mm_movemask_epi8(_mm_or_si128(v, _mm_cmpeq_epi8(v, zero)));
+		if(m)
+			return p - s + __builtin_ctz(m);
+	}
+#else
+	Word w;
+
+	e = s + n;
+	for(p = s; p < e && (uintptr_t)p % sizeof w; p++)
+		if(!isascii1(p))
+			return p - s;
+	for(; e - p >= sizeof w; p += sizeof w) {
+		memcpy(&w, p, sizeof w);
+		if(notascii(w))
+			break;
+	}
+#endif
+	while(p < e && isascii1(p))
+		p++;
+	return p - s;
+}
@@ -0,0 +1,31 @@
+/*
+ * Internal to libutf.
+ */
+long	__utfascii(const char*);
+long	__utfnascii(const char*, long);
+
+/*
+ * Rune classes, for runetype.c. A rune's class is found by way of
+ * runetab.h, which mkrunetab generates: the high bits of the rune
+ * select a block, and the low bits an entry within it.
+ */
+enum {
+	Plower	= 1<<0,
+	Pupper	= 1<<1,
+	Palpha	= 1<<2,
+	Pspace	= 1<<3,
+};
+
+enum {
+	RuneBlockBits	= 7,
+	RuneBlock	= 1<<RuneBlockBits,
+};
+
+typedef struct Runeclass Runeclass;
+struct Runeclass {
+	uchar	props;
+	/* Deltas to the rune's case mappings. */
+	int	upper;
+	int	lower;
+	int	title;
+};
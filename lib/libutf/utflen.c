@@ -15,6 +15,7 @@
 #include <string.h>
 #include "plan9.h"
 #include "utf.h"
+#include "utfdef.h"
 
 int
 utflen(const char *s)
@@ -29,9 +30,12 @@ utflen(const char *s)
 		if(c < Runeself) {
 			if(c == 0)
 				return n;
-			s++;
-		} else
+			c = __utfascii(s);
+			s += c;
+			n += c;
+		} else {
 			s += chartorune(&rune, s);
-		n++;
+			n++;
+		}
 	}
 }
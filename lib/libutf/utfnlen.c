@@ -15,6 +15,7 @@
 #include <string.h>
 #include "plan9.h"
 #include "utf.h"
+#include "utfdef.h"
 
 int
 utfnlen(const char *s, long m)
@@ -25,17 +26,20 @@ utfnlen(const char *s, long m)
 	const char *es;
 
 	es = s + m;
-	for(n = 0; s < es; n++) {
+	for(n = 0; s < es;) {
 		c = *(uchar*)s;
-		if(c < Runeself){
+		if(c < Runeself) {
 			if(c == '\0')
 				break;
-			s++;
+			c = __utfnascii(s, es-s);
+			s += c;
+			n += c;
 			continue;
 		}
 		if(!fullrune(s, es-s))
 			break;
 		s += chartorune(&rune, s);
+		n++;
 	}
 	return n;
 }
@@ -15,6 +15,7 @@
 #include <string.h>
 #include "plan9.h"
 #include "utf.h"
+#include "utfdef.h"
 
 char*
 utfrrune(const char *s, long c)
@@ -28,13 +29,10 @@ utfrrune(const char *s, long c)
 
 	s1 = 0;
 	for(;;) {
-		c1 = *(uchar*)s;
-		if(c1 < Runeself) {	/* one byte rune */
-			if(c1 == 0)
+		if(*(uchar*)s < Runeself) {
+			if(*s == 0)
 				return (char*)s1;
-			if(c1 == c)
-				s1 = s;
-			s++;
+			s += __utfascii(s);	/* one byte runes can't match */
 			continue;
 		}
 		c1 = chartorune(&r, s);
@@ -15,11 +15,11 @@
 #include <string.h>
 #include "plan9.h"
 #include "utf.h"
+#include "utfdef.h"
 
 char*
 utfrune(const char *s, long c)
 {
-	long c1;
 	Rune r;
 	int n;
 
@@ -27,13 +27,10 @@ utfrune(const char *s, long c)
 		return strchr(s, c);
 
 	for(;;) {
-		c1 = *(uchar*)s;
-		if(c1 < Runeself) {	/* one byte rune */
-			if(c1 == 0)
+		if(*(uchar*)s < Runeself) {
+			if(*s == 0)
 				return 0;
-			if(c1 == c)
-				return (char*)s;
-			s++;
+			s += __utfascii(s);	/* one byte runes can't match */
 			continue;
 		}
 		n = chartorune(&r, s);
@@ -0,0 +1,216 @@
+#if 0
+	set -e
+	name=fuzzbench
+	root=..
+	lib=$root/lib
+	inc=$root/include
+	menu=$root/cmd/menu
+	cc -I$inc -I$menu -I/usr/local/include -Os \
+		-o o.$name \
+		-Wall \
+		$name.c \
+		$menu/fuzzy.o \
+		-L$lib -lstuff -lfmt -lutf -lm
+
+	exec o.$name
+#endif
+/*
+ * Times wimenu's fuzzy matching over a million candidates: scoring
+ * with and without the charmask prefilter, and then picking the best
+ * FuzzyTop matches with a bounded heap, as fuzzy_flush does, rather
+ * than sorting them all. Scores are checked to be the same either
+ * way, and the heap's picks against the head of the sort.
+ *
+ * It links against cmd/menu/fuzzy.o, so build wimenu first.
+ */
+#include "dat.h"
+#include <math.h>
+#include <time.h>
+#include "fns.h"
+
+enum {
+	Nitem		= 1000000,
+	FuzzyTop	= 64,	/* As in cmd/menu/main.c. */
+};
+
+static Item*	items;
+static int*	scores;
+static Item**	scored;
+static int	nscored;
+
+static char*	words[] = {
+	"usr", "share", "doc", "lib", "bin", "src", "cmd", "menu", "wmii",
+	"local", "include", "x11", "fonts", "python", "site", "packages",
+	"README", "Makefile", "config", "main", "util", "test", "man",
+};
+
+static void
+mkitems(void) {
+	char buf[128];
+	int i, j, n;
+
+	items = emallocz(Nitem * sizeof *items);
+	scores = emalloc(Nitem * sizeof *scores);
+	scored = emalloc(Nitem * sizeof *scored);
+	srand(1);
+	for(i=0; i < Nitem; i++) {
+		n = 0;
+		for(j=2 + rand() % 5; j > 0; j--)
+			n += snprint(buf + n, sizeof buf - n, "/%s", words[rand() % nelem(words)]);
+		snprint(buf + n, sizeof buf - n, "_%d.%c", rand() % 1000, "cho"[rand() % 3]);
+		items[i].string = estrdup(buf);
+		items[i].len = strlen(buf);
+	}
+}
+
+static double
+now(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Scores every item, and collects the matches, as narrow() does. */
+static void
+score(void) {
+	int i;
+
+	nscored = 0;
+	for(i=0; i < Nitem; i++)
+		if((scores[i] = fuzzy_score(&items[i])) >= 0) {
+			items[i].score = scores[i];
+			scored[nscored++] = &items[i];
+		}
+}
+
+/* The heap of fuzzy_flush, with the same order: by score, then input order. */
+static bool
+better(int a, int b) {
+	return scored[a]->score > scored[b]->score
+	    || scored[a]->score == scored[b]->score && a < b;
+}
+
+static void
+siftdown(int *heap, int n, int i) {
+	int c, t;
+
+	for(; (c = 2*i + 1) < n; i = c) {
+		if(c + 1 < n && better(heap[c], heap[c + 1]))
+			c++;
+		if(!better(heap[i], heap[c]))
+			break;
+		t = heap[i];
+		heap[i] = heap[c];
+		heap[c] = t;
+	}
+}
+
+static int
+topk(int *heap) {
+	int i, k, t;
+
+	k = min(nscored, FuzzyTop);
+	for(i=0; i < k; i++)
+		heap[i] = i;
+	for(i=k/2 - 1; i >= 0; i--)
+		siftdown(heap, k, i);
+	for(i=k; i < nscored; i++)
+		if(better(i, heap[0])) {
+			heap[0] = i;
+			siftdown(heap, k, 0);
+		}
+	for(i=k; i > 1; i--) {
+		t = heap[0];
+		heap[0] = heap[i - 1];
+		heap[i - 1] = t;
+		siftdown(heap, i - 1, 0);
+	}
+	return k;
+}
+
+static int
+cmpscored(const void *a, const void *b) {
+	int i, j;
+
+	i = *(int*)a;
+	j = *(int*)b;
+	return better(i, j) ? -1 : better(j, i);
+}
+
+static int
+sortall(int *all) {
+	int i;
+
+	for(i=0; i < nscored; i++)
+		all[i] = i;
+	qsort(all, nscored, sizeof *all, cmpscored);
+	return nscored;
+}
+
+#define TIME(ms, expr) do {				\
+	double t0;					\
+	int n;						\
+	ms = HUGE_VAL;					\
+	for(n=0; n < 5; n++) {				\
+		t0 = now();				\
+		expr;					\
+		ms = fmin(ms, (now() - t0) * 1e3);	\
+	}						\
+} while(0)
+
+static void
+bench(char *filter) {
+	static int *prev, heap[FuzzyTop], *all;
+	double masked, unmasked, heapms, sortms;
+	int i, k;
+
+	if(prev == nil) {
+		prev = emalloc(Nitem * sizeof *prev);
+		all = emalloc(Nitem * sizeof *all);
+	}
+	fuzzy_prepare(filter, true);
+
+	/* Every item mask set to all ones, so that nothing is rejected early. */
+	for(i=0; i < Nitem; i++)
+		items[i].mask = ~0ULL;
+	TIME(unmasked, score());
+	memcpy(prev, scores, Nitem * sizeof *prev);
+
+	for(i=0; i < Nitem; i++)
+		items[i].mask = 0;
+	score();	/* Fill the masks in, as earlier keystrokes would have. */
+	TIME(masked, score());
+	if(memcmp(prev, scores, Nitem * sizeof *prev)) {
+		fprint(2, "fuzzbench: %q: the prefilter changed a score\n", filter);
+		exit(1);
+	}
+
+	TIME(heapms, k = topk(heap));
+	TIME(sortms, sortall(all));
+	if(memcmp(heap, all, k * sizeof *heap)) {
+		fprint(2, "fuzzbench: %q: the heap's top differs from the sort's\n", filter);
+		exit(1);
+	}
+
+	print("%-20q %7d %8.1f %8.1f %8.2f %8.1f\n",
+	      filter, nscored, unmasked, masked, heapms, sortms);
+}
+
+int
+main(void) {
+
+	quotefmtinstall();
+	mkitems();
+	print("%d items, times in ms\n", Nitem);
+	print("%-20s %7s %8s %8s %8s %8s\n",
+	      "filter", "matches", "nomask", "mask", "top64", "sortall");
+	bench("wm");
+	bench("mnu");
+	bench("qz");
+	bench("usrshare");
+	bench("usrsharedoc");
+	bench("srcwmiimenumain");
+	bench("usrsharedocREADMEzz");
+	return 0;
+}
@@ -0,0 +1,307 @@
+#if 0
+	set -e
+	name=transbench
+	root=..
+	lib=$root/lib
+	inc=$root/include
+	cc -I$inc -Os \
+		-o o.$name \
+		-Wall \
+		$name.c \
+		-L$lib -lfmt -lutf -lm
+
+	exec o.$name
+#endif
+/*
+ * Times wmiir's locale transcoding, with and without the bulk copy of
+ * ASCII runs, over ASCII and mixed text, and checks that both give
+ * the same bytes. flush and unflush are copies of those in
+ * cmd/wmiir.c, with the 9P and file writes replaced by a buffer. The
+ * bulk copy is skipped unless bulk is set, which leaves the per-rune
+ * path as it was before.
+ *
+ * wmiir only transcodes in a locale which isn't UTF-8. The first
+ * Latin-1 locale found is used, or C.
+ */
+#include <fmt.h>
+#include <limits.h>
+#include <locale.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <utf.h>
+#include <wchar.h>
+
+#define nil	((void*)0)
+#define min(a, b) ((a) < (b) ? (a) : (b))
+
+enum {
+	Size	= 4<<20,
+	Chunk	= 8192,		/* About an iounit. */
+	Msg	= 8192,		/* IXP_MAX_MSG */
+};
+
+typedef struct Sink Sink;
+struct Sink {
+	char*	data;
+	long	n;
+	long	size;
+};
+
+static Sink	sink;
+static bool	bulk;
+
+static int
+emit(char *buf, int n) {
+	if(sink.n + n > sink.size) {
+		sink.size = 2 * (sink.n + n);
+		sink.data = realloc(sink.data, sink.size);
+	}
+	memcpy(sink.data + sink.n, buf, n);
+	sink.n += n;
+	return n;
+}
+
+static int
+asciilen(char *s, int n) {
+	unsigned long w;
+	int i;
+
+	for(i=0; i + sizeof w <= n; i += sizeof w) {
+		memcpy(&w, s + i, sizeof w);
+		if(w & ~0UL / 0xff * 0x80)
+			break;
+	}
+	for(; i < n && !(s[i] & 0x80); i++)
+		;
+	return i;
+}
+
+/* Locale to UTF-8, as for wmiir write. */
+static bool
+flush(char *in, int len) {
+	static mbstate_t state;
+	static char buf[Msg];
+	static char *out = buf, *outend = buf + sizeof buf;
+	char *inend, *p;
+	wchar_t w;
+	Rune r;
+	int res, n;
+
+	inend = in + len;
+	do {
+		if(in == nil || out + UTFmax > outend) {
+			if(emit(buf, out - buf) != out - buf)
+				return false;
+			out = buf;
+		}
+		if(in == nil) {
+			state = (mbstate_t){0};
+			return true;
+		}
+
+		if(bulk && mbsinit(&state) && (n = asciilen(in, min(inend - in, outend - out)))) {
+			if((p = memchr(in, '\0', n)))
+				n = p - in;
+			memcpy(out, in, n);
+			in += n;
+			out += n;
+			if(p == nil)
+				continue;
+		}
+
+		switch((res = mbrtowc(&w, in, inend - in, &state))) {
+		case -1:
+			return false;
+		case 0:
+		case -2:
+			return true;
+		default:
+			in += res;
+			r = w < Runemax ? w : Runesync;
+			out += runetochar(out, &r);
+		}
+	} while(in < inend);
+	return true;
+}
+
+/* UTF-8 to the locale, as for wmiir read. */
+static bool
+unflush(char *in, int len) {
+	static mbstate_t state;
+	static char buf[Msg], extra[UTFmax];
+	static char *out = buf, *outend = buf + sizeof buf;
+	static int nextra;
+	char *start;
+	Rune r;
+	int res, n;
+
+	n = 0;
+	if(in) {
+		if((n = nextra)) {
+			nextra = 0;
+			while(len > 0 && n < UTFmax && !fullrune(extra, n)) {
+				extra[n++] = *in++;
+				len--;
+			}
+			unflush(extra, n);
+		}
+		n = utfnlen(in, len);
+	}
+
+	start = in;
+	do {
+		if(in == nil || out + MB_LEN_MAX > outend) {
+			if(emit(buf, out - buf) != out - buf)
+				return false;
+			out = buf;
+		}
+		if(in == nil || n == 0) {
+			state = (mbstate_t){0};
+			return true;
+		}
+
+		if(bulk && mbsinit(&state) && (res = asciilen(in, min(n, outend - out)))) {
+			memcpy(out, in, res);
+			in += res;
+			out += res;
+			n -= res;
+			continue;
+		}
+
+		in += chartorune(&r, in);
+		n--;
+		res = wcrtomb(out, r, &state);
+		if(res == -1)
+			*out++ = '?';
+		else
+			out += res;
+	} while(n > 0);
+
+	if(in < start + len) {
+		nextra = min(sizeof extra, len - (in - start));
+		memcpy(extra, in, nextra);
+	}
+	return true;
+}
+
+/* Runs the whole of text through f a chunk at a time, as wmiir does. */
+static void
+run(bool (*f)(char*, int), char *text, long len) {
+	long i;
+
+	sink.n = 0;
+	for(i=0; i < len; i += Chunk)
+		if(!f(text + i, min(Chunk, len - i))) {
+			fprint(2, "transbench: conversion failed\n");
+			exit(1);
+		}
+	f(nil, 0);
+}
+
+static double
+now(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* The best of a number of short rounds, taking turns. */
+static void
+bench(char *name, bool (*f)(char*, int), char *text, long len) {
+	double t0, t, rate[2];
+	char *first;
+	long nfirst, n;
+	int i, j;
+
+	bulk = false;
+	run(f, text, len);
+	first = malloc(sink.n);
+	memcpy(first, sink.data, sink.n);
+	nfirst = sink.n;
+	bulk = true;
+	run(f, text, len);
+	if(sink.n != nfirst || memcmp(first, sink.data, nfirst)) {
+		fprint(2, "transbench: %s: output differs\n", name);
+		exit(1);
+	}
+	free(first);
+
+	rate[0] = rate[1] = 0;
+	for(i=0; i < 10; i++)
+		for(j=0; j < 2; j++) {
+			bulk = j;
+			for(n=0, t0=now(); (t = now() - t0) < .05; n++)
+				run(f, text, len);
+			rate[j] = fmax(rate[j], n * (len / 1e6) / t);
+		}
+	print("\t%-14s %8.0f %8.0f MB/s  %5.1fx\n", name, rate[0], rate[1], rate[1]/rate[0]);
+}
+
+static Rune	latin[] = { 0xE9, 0xE8, 0xFC, 0xDF };
+
+/*
+ * About Size bytes of UTF-8, of which one rune in every is not
+ * ASCII, or none if every is 0.
+ */
+static char*
+mktext(int every, long *len) {
+	char *text, *p, *e;
+	Rune r;
+
+	text = malloc(Size + UTFmax);
+	srand(1);
+	p = text;
+	e = p + Size;
+	while(p < e) {
+		if(every && rand() % every == 0)
+			r = latin[rand() % 4];
+		else if(rand() % 30 == 0)
+			r = '\n';
+		else if(rand() % 6 == 0)
+			r = ' ';
+		else
+			r = 'a' + rand() % 26;
+		p += runetochar(p, &r);
+	}
+	*len = p - text;
+	return text;
+}
+
+static char*	locales[] = {
+	"en_US.ISO-8859-1", "en_US.iso88591", "de_DE.ISO-8859-1",
+	"de_DE.iso88591", "fr_FR.ISO-8859-1", "C",
+};
+
+int
+main(void) {
+	char *utf, *local;
+	long len, nlocal;
+	int i, every;
+
+	for(i=0; !setlocale(LC_CTYPE, locales[i]); i++)
+		;
+	print("locale %s\n", locales[i]);
+	print("\t               per-rune     bulk  (MB of input per second)\n");
+
+	for(every=0; every <= 16; every += 16) {
+		utf = mktext(every, &len);
+		print("%s:\n", every ? "mixed (1 in 16 Latin-1)" : "ascii");
+
+		/* The locale's version is what a read gives back. */
+		bulk = false;
+		run(unflush, utf, len);
+		nlocal = sink.n;
+		local = malloc(nlocal);
+		memcpy(local, sink.data, nlocal);
+
+		bench("read", unflush, utf, len);
+		bench("write", flush, local, nlocal);
+		free(utf);
+		free(local);
+	}
+	return 0;
+}
@@ -0,0 +1,227 @@
+#if 0
+	set -e
+	name=utfbench
+	root=..
+	lib=$root/lib
+	inc=$root/include
+	cc -I$inc -Os \
+		-o o.$name \
+		-Wall \
+		$name.c \
+		-L$lib -lfmt -lutf -lm
+
+	exec o.$name
+#endif
+/*
+ * Times libutf's scanning functions against the rune-at-a-time
+ * versions they replaced, kept below, over ASCII, mixed and CJK text.
+ * Each pair is checked to agree before it is timed.
+ *
+ * config.mk builds with DEBUGCFLAGS, at -O0, by default. For figures
+ * worth comparing, build libutf and this with "make DEBUGCFLAGS=".
+ */
+#include <fmt.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <utf.h>
+
+#define nelem(ary) (sizeof(ary) / sizeof(*ary))
+
+enum {
+	Size	= 1<<20,
+	Absent	= 0x263A,	/* ☺, which never appears in the input. */
+};
+
+static int
+old_utflen(const char *s) {
+	int c;
+	long n;
+	Rune rune;
+
+	n = 0;
+	for(;;) {
+		c = *(unsigned char*)s;
+		if(c < Runeself) {
+			if(c == 0)
+				return n;
+			s++;
+		} else
+			s += chartorune(&rune, s);
+		n++;
+	}
+}
+
+static char*
+old_utfrune(const char *s, long c) {
+	long c1;
+	Rune r;
+	int n;
+
+	if(c < Runesync)
+		return strchr(s, c);
+
+	for(;;) {
+		c1 = *(unsigned char*)s;
+		if(c1 < Runeself) {
+			if(c1 == 0)
+				return 0;
+			if(c1 == c)
+				return (char*)s;
+			s++;
+			continue;
+		}
+		n = chartorune(&r, s);
+		if(r == c)
+			return (char*)s;
+		s += n;
+	}
+}
+
+static char*
+old_utfutf(const char *s1, const char *s2) {
+	const char *p;
+	long f, n1, n2;
+	Rune r;
+
+	n1 = chartorune(&r, s2);
+	f = r;
+	if(f <= Runesync)
+		return strstr(s1, s2);
+
+	n2 = strlen(s2);
+	for(p=s1; (p = old_utfrune(p, f)); p+=n1)
+		if(strncmp(p, s2, n2) == 0)
+			return (char*)p;
+	return 0;
+}
+
+static long
+old_runestrlen(const Rune *s) {
+	const Rune *p;
+
+	for(p=s; *p; p++)
+		;
+	return p - s;
+}
+
+typedef struct Input Input;
+struct Input {
+	char*	name;
+	char*	text;
+	Rune*	runes;
+	char*	needle;	/* Absent, followed by a rune which is present. */
+};
+
+static Rune	cjk[] = { 0x4E2D, 0x6587, 0x5B57, 0x7B26, 0x8868, 0x793A };
+static Rune	latin[] = { 0xE9, 0xE8, 0xFC, 0xDF };
+
+/*
+ * Fills in about a megabyte of text, of which one rune in every is
+ * not ASCII, or none if every is 0.
+ */
+static void
+mkinput(Input *in, char *name, int every) {
+	char *p, *e;
+	Rune r;
+	long n;
+
+	in->name = name;
+	in->text = malloc(Size + UTFmax + 1);
+	in->runes = malloc((Size + 1) * sizeof *in->runes);
+	srand(1);
+	n = 0;
+	p = in->text;
+	e = p + Size;
+	while(p < e) {
+		if(every && rand() % every == 0)
+			r = every == 1 ? cjk[rand() % nelem(cjk)] : latin[rand() % nelem(latin)];
+		else if(rand() % 6 == 0)
+			r = ' ';
+		else
+			r = 'a' + rand() % 26;
+		p += runetochar(p, &r);
+		in->runes[n++] = r;
+	}
+	*p = '\0';
+	in->runes[n] = 0;
+
+	in->needle = malloc(2*UTFmax + 1);
+	r = Absent;
+	n = runetochar(in->needle, &r);
+	r = every == 1 ? cjk[0] : 'a';
+	in->needle[n + runetochar(in->needle + n, &r)] = '\0';
+}
+
+static double
+now(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static volatile long	sink;
+
+/*
+ * The best of a number of short rounds, taking turns, so that other
+ * load on the machine falls on both alike.
+ */
+#define ROUND(res, expr) do {					\
+	double t0, t;						\
+	long n;							\
+	for(n=0, t0=now(); (t = now() - t0) < .05; n++)	\
+		sink += (long)(expr);				\
+	res = fmax(res, n * (Size / 1e6) / t);			\
+} while(0)
+
+#define TIME(name, oldexpr, newexpr) do {			\
+	double old, new;					\
+	int i;							\
+	old = new = 0;						\
+	for(i=0; i < 10; i++) {					\
+		ROUND(old, oldexpr);				\
+		ROUND(new, newexpr);				\
+	}							\
+	print("\t%-10s  %8.0f %8.0f MB/s  %5.1fx\n",		\
+	      name, old, new, new/old);				\
+} while(0)
+
+static void
+check(bool ok, char *what, Input *in) {
+	if(!ok) {
+		fprint(2, "utfbench: %s disagrees on %s input\n", what, in->name);
+		exit(1);
+	}
+}
+
+static void
+bench(Input *in) {
+
+	check(old_utflen(in->text) == utflen(in->text), "utflen", in);
+	check(old_utfrune(in->text, Absent) == utfrune(in->text, Absent), "utfrune", in);
+	check(old_utfutf(in->text, in->needle) == utfutf(in->text, in->needle), "utfutf", in);
+	check(old_runestrlen(in->runes) == runestrlen(in->runes), "runestrlen", in);
+
+	print("%s:\n", in->name);
+	TIME("utflen", old_utflen(in->text), utflen(in->text));
+	TIME("utfrune", old_utfrune(in->text, Absent), utfrune(in->text, Absent));
+	TIME("utfutf", old_utfutf(in->text, in->needle), utfutf(in->text, in->needle));
+	TIME("runestrlen", old_runestrlen(in->runes), runestrlen(in->runes));
+}
+
+int
+main(void) {
+	Input in;
+
+	print("\t            baseline   libutf  (MB of UTF-8 input per second)\n");
+	mkinput(&in, "ascii", 0);
+	bench(&in);
+	mkinput(&in, "mixed (1 in 16 Latin-1)", 16);
+	bench(&in);
+	mkinput(&in, "CJK", 1);
+	bench(&in);
+	return 0;
+}